@@ -0,0 +1,290 @@
+#include "APSP.h"
+#include "Parallel.h"
+#include "PriorityQueue.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+DistanceMatrix::DistanceMatrix()
+{
+	m_Size = 0;
+	m_Stride = 0;
+}
+
+void DistanceMatrix::init(int size)
+{
+	m_Size = size > 0 ? size : 0;
+	m_Stride = (m_Size + APSP_TILE - 1) / APSP_TILE * APSP_TILE;
+	m_Data.assign((size_t)m_Stride * m_Stride, INF);
+	for (int i = 0; i < m_Stride; i++)
+		m_Data[(size_t)i * m_Stride + i] = 0;
+}
+
+// c[j] = min(c[j], a + b[j]) for one tile row, b[j] == INF never relaxes
+// branchless min-plus, a != INF is checked by the caller
+static inline void minPlusRow(int *c, int a, const int *b)
+{
+	int j = 0;
+#if defined(__AVX2__)
+	__m256i inf8 = _mm256_set1_epi32(INF);
+	__m256i a8 = _mm256_set1_epi32(a);
+	for (; j + 8 <= APSP_TILE; j += 8)
+	{
+		__m256i bv = _mm256_loadu_si256((const __m256i *)(b + j));
+		__m256i sum = _mm256_blendv_epi8(_mm256_add_epi32(a8, bv), inf8, _mm256_cmpeq_epi32(bv, inf8));
+		__m256i cv = _mm256_loadu_si256((const __m256i *)(c + j));
+		_mm256_storeu_si256((__m256i *)(c + j), _mm256_min_epi32(cv, sum));
+	}
+#elif defined(__SSE2__) || defined(_M_X64)
+	__m128i inf4 = _mm_set1_epi32(INF);
+	__m128i a4 = _mm_set1_epi32(a);
+	for (; j + 4 <= APSP_TILE; j += 4)
+	{
+		__m128i bv = _mm_loadu_si128((const __m128i *)(b + j));
+		__m128i isInf = _mm_cmpeq_epi32(bv, inf4);
+		__m128i sum = _mm_or_si128(_mm_andnot_si128(isInf, _mm_add_epi32(a4, bv)), _mm_and_si128(isInf, inf4));
+		__m128i cv = _mm_loadu_si128((const __m128i *)(c + j));
+		__m128i greater = _mm_cmpgt_epi32(cv, sum);
+		_mm_storeu_si128((__m128i *)(c + j), _mm_or_si128(_mm_and_si128(greater, sum), _mm_andnot_si128(greater, cv)));
+	}
+#endif
+	for (; j < APSP_TILE; j++)
+	{
+		int sum = b[j] == INF ? INF : a + b[j];
+		c[j] = sum < c[j] ? sum : c[j];
+	}
+}
+
+// relax tile C through the pivot rows/columns of tile K : C[i][j] = min(C[i][j], A[i][k] + B[k][j])
+// A = tile (ci, kk), B = tile (kk, cj), C = tile (ci, cj), tile indices in units of APSP_TILE
+static void relaxTile(DistanceMatrix &dist, int ci, int cj, int kk)
+{
+	int base = kk * APSP_TILE;
+	for (int k = 0; k < APSP_TILE; k++)
+	{
+		const int *bRow = dist.row(base + k) + cj * APSP_TILE;
+		for (int i = 0; i < APSP_TILE; i++)
+		{
+			int *cRow = dist.row(ci * APSP_TILE + i) + cj * APSP_TILE;
+			int a = dist.row(ci * APSP_TILE + i)[base + k];
+			if (a != INF)
+				minPlusRow(cRow, a, bRow);
+		}
+	}
+}
+
+// Blocked Floyd-Warshall, phase 1 (pivot tile), phase 2 (pivot row/column), phase 3 (rest)
+bool floydWarshall(Graph *graph, char option, DistanceMatrix &dist)
+{
+	int size = graph->getSize();
+	dist.init(size);
+
+	// Enter initial edge information
+	for (int i = 0; i < size; i++)
+	{
+		int *row = dist.row(i);
+		graph->forEachNeighbor(i, option, [&](int v, int w)
+		{
+			// Select the smallest weight
+			if (row[v] > w)
+				row[v] = w;
+		});
+	}
+
+	int tiles = dist.getStride() / APSP_TILE;
+	for (int kk = 0; kk < tiles; kk++)
+	{
+		// phase 1 : pivot tile depends only on itself
+		relaxTile(dist, kk, kk, kk);
+
+		// phase 2 : tiles sharing the pivot row or column
+		parallelFor(0, 2 * tiles, [&](int t, int)
+		{
+			int other = t / 2;
+			if (other == kk)
+				return;
+			if (t % 2 == 0)
+				relaxTile(dist, kk, other, kk);
+			else
+				relaxTile(dist, other, kk, kk);
+		});
+
+		// phase 3 : every remaining tile is independent within this round
+		parallelFor(0, tiles * tiles, [&](int t, int)
+		{
+			int ci = t / tiles, cj = t % tiles;
+			if (ci != kk && cj != kk)
+				relaxTile(dist, ci, cj, kk);
+		});
+	}
+
+	// Check negative cycle
+	for (int i = 0; i < size; i++)
+	{
+		if (dist.at(i, i) < 0)
+			return false;
+	}
+	return true;
+}
+
+// Bellman-Ford from a virtual source joined to every vertex with weight 0
+// h receives the potentials, false if a negative cycle exists
+static bool johnsonPotential(Graph *graph, char option, vector<int> &h)
+{
+	int size = graph->getSize();
+	h.assign(size, 0);
+
+	// without negative edges every potential stays 0
+	bool negative = false;
+	for (int u = 0; u < size && !negative; u++)
+	{
+		graph->forEachNeighbor(u, option, [&](int, int w)
+		{
+			if (w < 0)
+				negative = true;
+		});
+	}
+	if (!negative)
+		return true;
+
+	// queue driven relaxation, every vertex starts reachable from the virtual source
+	vector<int> edges(size, 1); // edges on the current path to every vertex, virtual source edge included
+	vector<bool> queued(size, true);
+	queue<int> q;
+	for (int v = 0; v < size; v++)
+		q.push(v);
+
+	while (!q.empty())
+	{
+		int u = q.front();
+		q.pop();
+		queued[u] = false;
+
+		bool cycle = false;
+		graph->forEachNeighbor(u, option, [&](int v, int w)
+		{
+			if (cycle || h[v] <= h[u] + w)
+				return;
+			h[v] = h[u] + w;
+			edges[v] = edges[u] + 1;
+			// a shortest path has at most V edges (virtual source included)
+			if (edges[v] > size)
+				cycle = true;
+			else if (!queued[v])
+			{
+				queued[v] = true;
+				q.push(v);
+			}
+		});
+		if (cycle)
+			return false;
+	}
+	return true;
+}
+
+bool johnson(Graph *graph, char option, DistanceMatrix &dist)
+{
+	int size = graph->getSize();
+	dist.init(size);
+
+	vector<int> h;
+	if (!johnsonPotential(graph, option, h))
+		return false;
+
+	// one indexed heap per worker, reused for every source it handles
+	vector<IndexedHeap> heaps(workerCount(), IndexedHeap(size));
+
+	parallelFor(0, size, [&](int s, int worker)
+	{
+		int *d = dist.row(s); // reweighted distances are written in place
+		IndexedHeap &heap = heaps[worker];
+
+		heap.push(s, 0);
+		while (!heap.empty())
+		{
+			int u = heap.pop();
+			int cost = d[u];
+
+			graph->forEachNeighbor(u, option, [&](int v, int w)
+			{
+				int reweighted = w + h[u] - h[v]; // non-negative after reweighting
+				if (d[v] > cost + reweighted)
+				{
+					d[v] = cost + reweighted;
+					heap.push(v, d[v]);
+				}
+			});
+		}
+
+		// undo the reweighting
+		for (int v = 0; v < size; v++)
+		{
+			if (d[v] != INF)
+				d[v] = d[v] - h[s] + h[v];
+		}
+	});
+	return true;
+}
+
+bool allPairsShortestPaths(Graph *graph, char option, DistanceMatrix &dist)
+{
+	long long vertices = graph->getSize();
+	if ((long long)graph->getEdgeCount() * APSP_SPARSE_RATIO < vertices * vertices)
+		return johnson(graph, option, dist);
+	return floydWarshall(graph, option, dist);
+}
+
+APSPCache::APSPCache()
+{
+	m_Generation = 0;
+	m_Entry[0].generation = m_Entry[1].generation = -1;
+}
+
+void APSPCache::invalidate()
+{
+	m_Generation++;
+	// release the matrices of the old graph
+	drop('O');
+	drop('X');
+}
+
+void APSPCache::drop(char option)
+{
+	APSPEntry &entry = slot(option);
+	entry.generation = -1;
+	entry.dist = DistanceMatrix();
+	vector<int>().swap(entry.parent);
+}
+
+APSPEntry *APSPCache::find(char option)
+{
+	APSPEntry &entry = slot(option);
+	return entry.generation == m_Generation ? &entry : nullptr;
+}
+
+APSPEntry *APSPCache::get(Graph *graph, char option)
+{
+	APSPEntry &entry = slot(option);
+	if (entry.generation == m_Generation)
+		return &entry;
+
+	int size = graph->getSize();
+	entry.generation = m_Generation;
+	entry.range = scanWeights(graph, option);
+	entry.valid = allPairsShortestPaths(graph, option, entry.dist);
+	entry.hasParent = entry.valid && size > 0 && (!entry.range.hasEdge || entry.range.minWeight > 0);
+	vector<int>().swap(entry.parent);
+	if (entry.hasParent)
+	{
+		// one parent row per source from its distance row
+		entry.parent.resize((size_t)size * size);
+		parallelFor(0, size, [&](int s, int)
+		{
+			tightParents(graph, option, s, entry.dist.row(s), &entry.parent[(size_t)s * size]);
+		});
+	}
+	return &entry;
+}
@@ -0,0 +1,75 @@
+#ifndef _APSP_H_
+#define _APSP_H_
+
+#include "Graph.h"
+#include "SSSP.h"
+
+// Flat all-pairs distance matrix, rows padded to a multiple of the tile size
+// padding vertices are isolated (INF) so they never shorten a real path
+class DistanceMatrix
+{
+private:
+	int m_Size;
+	int m_Stride;
+	vector<int> m_Data;
+
+public:
+	DistanceMatrix();
+
+	void init(int size); // INF everywhere except the zero diagonal
+	int getSize() { return m_Size; }
+	int getStride() { return m_Stride; }
+	int *row(int i) { return &m_Data[(size_t)i * m_Stride]; }
+	int at(int i, int j) { return m_Data[(size_t)i * m_Stride + j]; }
+};
+
+// Tile edge used by the blocked Floyd-Warshall
+const int APSP_TILE = 64;
+
+// Johnson is used when edges * APSP_SPARSE_RATIO < vertices^2
+const int APSP_SPARSE_RATIO = 32;
+
+// All functions : option 'O' directed, otherwise undirected
+// return false if a negative cycle exists
+
+// Blocked Floyd-Warshall over the graph edges
+bool floydWarshall(Graph *graph, char option, DistanceMatrix &dist);
+// Bellman-Ford reweighting followed by one Dijkstra per source in parallel
+bool johnson(Graph *graph, char option, DistanceMatrix &dist);
+// Picks Johnson for sparse graphs, Floyd-Warshall otherwise
+bool allPairsShortestPaths(Graph *graph, char option, DistanceMatrix &dist);
+
+// All-pairs result for one option of one loaded graph
+struct APSPEntry
+{
+	int generation;		// graph generation the entry was computed for, -1 if empty
+	bool valid;			// false if a negative cycle was found
+	bool hasParent;		// parent matrix built, only when every weight > 0
+	WeightRange range;
+	DistanceMatrix dist;
+	vector<int> parent; // parent[s * size + v] : last hop on the s -> v path, -1 for s and unreachable
+};
+
+// All-pairs results shared by FLOYD, CENTRALITY and the path queries
+// keyed by (graph generation, directed / undirected), invalidate() starts a new generation
+class APSPCache
+{
+private:
+	APSPEntry m_Entry[2]; // 'O', 'X'
+	int m_Generation;
+
+	APSPEntry &slot(char option) { return m_Entry[option == 'O' ? 0 : 1]; }
+
+public:
+	APSPCache();
+
+	void invalidate();
+	// releases the entry of one option, recomputed on the next get()
+	void drop(char option);
+	// entry of the current generation, computed on first use
+	APSPEntry *get(Graph *graph, char option);
+	// entry of the current generation if already computed, nullptr otherwise
+	APSPEntry *find(char option);
+};
+
+#endif
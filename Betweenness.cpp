@@ -0,0 +1,107 @@
+#include "Betweenness.h"
+#include "Parallel.h"
+#include "PriorityQueue.h"
+
+// Per worker state of one single source pass, reset only where it was touched
+struct BrandesWorkspace
+{
+	vector<int> dist;
+	vector<int> rank;	   // settle position, -1 if not settled
+	vector<double> sigma; // number of shortest paths from the source
+	vector<double> delta; // dependency of the source on the vertex
+	vector<int> order;	   // vertices in settle order
+	IndexedHeap pq;
+
+	BrandesWorkspace(int size) : dist(size, INF), rank(size, -1), sigma(size, 0.0), delta(size, 0.0), pq(size) {}
+};
+
+// Dijkstra from source counting shortest paths, then dependencies in reverse settle order
+// predecessors are the tight in-neighbors settled earlier, so zero weights cannot form a cycle
+static void brandesPass(Graph *graph, char option, int source, BrandesWorkspace &ws, vector<double> &score)
+{
+	EdgeDirection forward = option == 'O' ? EDGE_OUT : EDGE_BOTH;
+	EdgeDirection backward = option == 'O' ? EDGE_IN : EDGE_BOTH;
+
+	ws.dist[source] = 0;
+	ws.pq.push(source, 0);
+	while (!ws.pq.empty())
+	{
+		int v = ws.pq.pop();
+		ws.rank[v] = (int)ws.order.size();
+		ws.order.push_back(v);
+
+		// paths to v come through its settled tight predecessors
+		if (v == source)
+			ws.sigma[v] = 1.0;
+		graph->forEachEdge(v, backward, [&](int u, int w)
+		{
+			if (ws.rank[u] != -1 && ws.rank[u] < ws.rank[v] && ws.dist[u] + w == ws.dist[v])
+				ws.sigma[v] += ws.sigma[u];
+		});
+		graph->forEachEdge(v, forward, [&](int x, int w)
+		{
+			if (ws.dist[v] + w < ws.dist[x])
+			{
+				ws.dist[x] = ws.dist[v] + w;
+				ws.pq.push(x, ws.dist[x]);
+			}
+		});
+	}
+
+	// dependencies flow back from the farthest vertex
+	for (int i = (int)ws.order.size() - 1; i >= 0; i--)
+	{
+		int v = ws.order[i];
+		graph->forEachEdge(v, backward, [&](int u, int w)
+		{
+			if (ws.rank[u] != -1 && ws.rank[u] < ws.rank[v] && ws.dist[u] + w == ws.dist[v])
+				ws.delta[u] += ws.sigma[u] / ws.sigma[v] * (1.0 + ws.delta[v]);
+		});
+		if (v != source)
+			score[v] += ws.delta[v];
+	}
+
+	// reset what this pass touched
+	for (size_t i = 0; i < ws.order.size(); i++)
+	{
+		int v = ws.order[i];
+		ws.dist[v] = INF;
+		ws.rank[v] = -1;
+		ws.sigma[v] = 0.0;
+		ws.delta[v] = 0.0;
+	}
+	ws.order.clear();
+}
+
+void betweenness(Graph *graph, char option, const vector<int> &sources, vector<double> &score)
+{
+	int size = graph->getSize();
+	int workers = workerCount();
+	score.assign(size, 0.0);
+	if (sources.empty())
+		return;
+
+	// workspaces and accumulators are created lazily by the worker that uses them
+	vector<BrandesWorkspace *> workspace(workers, nullptr);
+	vector<vector<double>> partial(workers);
+	parallelFor(0, (int)sources.size(), [&](int i, int worker)
+	{
+		if (workspace[worker] == nullptr)
+		{
+			workspace[worker] = new BrandesWorkspace(size);
+			partial[worker].assign(size, 0.0);
+		}
+		brandesPass(graph, option, sources[i], *workspace[worker], partial[worker]);
+	});
+
+	// merge, undirected pairs were seen from both ends
+	double scale = (double)size / sources.size() * (option == 'O' ? 1.0 : 0.5);
+	for (int w = 0; w < workers; w++)
+	{
+		for (size_t v = 0; v < partial[w].size(); v++)
+			score[v] += partial[w][v];
+		delete workspace[w];
+	}
+	for (int v = 0; v < size; v++)
+		score[v] *= scale;
+}
@@ -0,0 +1,15 @@
+#ifndef _BETWEENNESS_H_
+#define _BETWEENNESS_H_
+
+#include "Graph.h"
+
+// Vertices reported by BETWEENNESS when no TOP count is given
+const int BETWEENNESS_TOP = 10;
+
+// Brandes betweenness from the listed sources, weights must be non-negative
+// sources run in parallel, each worker accumulates dependencies into its own score array
+// option 'O' directed, otherwise undirected (every pair counted once)
+// scores are scaled by size / sources.size() so a sample estimates the full value
+void betweenness(Graph *graph, char option, const vector<int> &sources, vector<double> &score);
+
+#endif
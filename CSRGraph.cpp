@@ -0,0 +1,369 @@
+#include "CSRGraph.h"
+#include "TextFormat.h"
+#include "GraphFile.h"
+#include <iostream>
+#include <utility>
+
+using namespace std;
+
+// Stable counting sort of edge ids by key[id], key range [0, size)
+// offset (size + 1) receives the start position of every key
+static void countingSortBy(const vector<int> &key, int size, const vector<int> &in, vector<int> &out, vector<int> &offset)
+{
+	offset.assign(size + 1, 0);
+	for (size_t i = 0; i < in.size(); i++)
+		offset[key[in[i]] + 1]++;
+	for (int v = 0; v < size; v++)
+		offset[v + 1] += offset[v];
+
+	vector<int> pos(offset.begin(), offset.end() - 1);
+	out.resize(in.size());
+	for (size_t i = 0; i < in.size(); i++)
+		out[pos[key[in[i]]]++] = in[i];
+}
+
+// Constructor - Graph Initialization
+CSRGraph::CSRGraph(bool type, int size, char format) : Graph(type, size)
+{
+	m_Format = format;
+	m_Built = true;
+	m_Mapping = nullptr;
+	m_OwnOutOffset.assign(size + 1, 0);
+	m_OwnInOffset.assign(size + 1, 0);
+	useOwnArrays();
+}
+
+// destructor
+CSRGraph::~CSRGraph()
+{
+	delete m_Mapping;
+}
+
+void CSRGraph::useOwnArrays()
+{
+	m_OutOffset = m_OwnOutOffset.data();
+	m_OutTarget = m_OwnOutTarget.data();
+	m_OutWeight = m_OwnOutWeight.data();
+	m_InOffset = m_OwnInOffset.data();
+	m_InSource = m_OwnInSource.data();
+	m_InWeight = m_OwnInWeight.data();
+	delete m_Mapping;
+	m_Mapping = nullptr;
+}
+
+void CSRGraph::attach(MappedFile *mapping, int edgeCount, int *outOffset, int *outTarget, int *outWeight, int *inOffset, int *inSource, int *inWeight)
+{
+	useOwnArrays();
+	vector<int>().swap(m_OwnOutOffset);
+	vector<int>().swap(m_OwnInOffset);
+	m_OutOffset = outOffset;
+	m_OutTarget = outTarget;
+	m_OutWeight = outWeight;
+	m_EdgeCount = edgeCount;
+
+	if (inOffset == nullptr)
+	{
+		// reverse index from the forward one : edges in (from, to) order, stable by target
+		m_OwnInOffset.assign(m_Size + 1, 0);
+		for (int e = 0; e < edgeCount; e++)
+			m_OwnInOffset[outTarget[e] + 1]++;
+		for (int v = 0; v < m_Size; v++)
+			m_OwnInOffset[v + 1] += m_OwnInOffset[v];
+		vector<int> pos(m_OwnInOffset.begin(), m_OwnInOffset.end() - 1);
+		m_OwnInSource.resize(edgeCount);
+		m_OwnInWeight.resize(edgeCount);
+		for (int u = 0; u < m_Size; u++)
+		{
+			for (int e = outOffset[u]; e < outOffset[u + 1]; e++)
+			{
+				int slot = pos[outTarget[e]]++;
+				m_OwnInSource[slot] = u;
+				m_OwnInWeight[slot] = outWeight[e];
+			}
+		}
+		inOffset = m_OwnInOffset.data();
+		inSource = m_OwnInSource.data();
+		inWeight = m_OwnInWeight.data();
+	}
+	m_InOffset = inOffset;
+	m_InSource = inSource;
+	m_InWeight = inWeight;
+	m_Mapping = mapping;
+	m_Built = true;
+}
+
+// Compact staged edges (and any previously built edges) into forward/reverse CSR
+void CSRGraph::build()
+{
+	if (m_Built)
+		return;
+
+	// already compacted edges are staged ahead of the new ones,
+	// so parallel edges keep their insertion order like in ListGraph
+	int compacted = m_OutOffset[m_Size];
+	int edgeCount = compacted + (int)m_PendingFrom.size();
+	vector<int> from, to, weight;
+	from.reserve(edgeCount);
+	to.reserve(edgeCount);
+	weight.reserve(edgeCount);
+	for (int u = 0; u < m_Size; u++)
+	{
+		for (int e = m_OutOffset[u]; e < m_OutOffset[u + 1]; e++)
+		{
+			from.push_back(u);
+			to.push_back(m_OutTarget[e]);
+			weight.push_back(m_OutWeight[e]);
+		}
+	}
+	from.insert(from.end(), m_PendingFrom.begin(), m_PendingFrom.end());
+	to.insert(to.end(), m_PendingTo.begin(), m_PendingTo.end());
+	weight.insert(weight.end(), m_PendingWeight.begin(), m_PendingWeight.end());
+	m_PendingFrom.swap(from);
+	m_PendingTo.swap(to);
+	m_PendingWeight.swap(weight);
+
+	vector<int> ids(edgeCount), tmp, order, unused;
+	for (int e = 0; e < edgeCount; e++)
+		ids[e] = e;
+
+	// forward index: sort by target, then stable by source -> (from, to) order
+	countingSortBy(m_PendingTo, m_Size, ids, tmp, unused);
+	countingSortBy(m_PendingFrom, m_Size, tmp, order, m_OwnOutOffset);
+	m_OwnOutTarget.resize(edgeCount);
+	m_OwnOutWeight.resize(edgeCount);
+	for (int i = 0; i < edgeCount; i++)
+	{
+		m_OwnOutTarget[i] = m_PendingTo[order[i]];
+		m_OwnOutWeight[i] = m_PendingWeight[order[i]];
+	}
+
+	// reverse index: sort by source, then stable by target -> (to, from) order
+	countingSortBy(m_PendingFrom, m_Size, ids, tmp, unused);
+	countingSortBy(m_PendingTo, m_Size, tmp, order, m_OwnInOffset);
+	m_OwnInSource.resize(edgeCount);
+	m_OwnInWeight.resize(edgeCount);
+	for (int i = 0; i < edgeCount; i++)
+	{
+		m_OwnInSource[i] = m_PendingFrom[order[i]];
+		m_OwnInWeight[i] = m_PendingWeight[order[i]];
+	}
+
+	// release staging memory
+	vector<int>().swap(m_PendingFrom);
+	vector<int>().swap(m_PendingTo);
+	vector<int>().swap(m_PendingWeight);
+	useOwnArrays(); // a mapped file is no longer needed
+	m_Built = true;
+}
+
+// undirected perspective, O(degree)
+void CSRGraph::getAdjacentEdges(int vertex, multimap<int, int> *m)
+{
+	if (vertex < 0 || vertex >= m_Size)
+		return;
+	build();
+
+	// all out-degree edges
+	for (int e = m_OutOffset[vertex]; e < m_OutOffset[vertex + 1]; e++)
+		m->insert(make_pair(m_OutTarget[e], m_OutWeight[e]));
+
+	// all in-degree edges (self loop already added above)
+	for (int e = m_InOffset[vertex]; e < m_InOffset[vertex + 1]; e++)
+	{
+		if (m_InSource[e] == vertex)
+			continue;
+		m->insert(make_pair(m_InSource[e], m_InWeight[e]));
+	}
+}
+
+// Directed perspective, O(out-degree)
+void CSRGraph::getAdjacentEdgesDirect(int vertex, multimap<int, int> *m)
+{
+	if (vertex < 0 || vertex >= m_Size)
+		return;
+	build();
+
+	for (int e = m_OutOffset[vertex]; e < m_OutOffset[vertex + 1]; e++)
+		m->insert(make_pair(m_OutTarget[e], m_OutWeight[e]));
+}
+
+// visit edges straight from the CSR arrays, ascending neighbor order
+void CSRGraph::visitEdges(int vertex, EdgeDirection dir, EdgeVisitor visit, void *context)
+{
+	if (vertex < 0 || vertex >= m_Size)
+		return;
+	build();
+
+	int out = m_OutOffset[vertex], outEnd = m_OutOffset[vertex + 1];
+	int in = m_InOffset[vertex], inEnd = m_InOffset[vertex + 1];
+	if (dir == EDGE_OUT)
+		in = inEnd;
+	else if (dir == EDGE_IN)
+		out = outEnd;
+
+	// merge the two sorted ranges, undirected self loop only once
+	while (out < outEnd || in < inEnd)
+	{
+		if (dir == EDGE_BOTH && in < inEnd && m_InSource[in] == vertex)
+		{
+			in++;
+			continue;
+		}
+		if (in == inEnd || (out < outEnd && m_OutTarget[out] <= m_InSource[in]))
+		{
+			if (!visit(context, m_OutTarget[out], m_OutWeight[out]))
+				return;
+			out++;
+		}
+		else
+		{
+			if (!visit(context, m_InSource[in], m_InWeight[in]))
+				return;
+			in++;
+		}
+	}
+}
+
+// Insert edge, staged until the next build()
+void CSRGraph::insertEdge(int from, int to, int weight)
+{
+	if (from < 0 || from >= m_Size || to < 0 || to >= m_Size)
+		return;
+
+	m_PendingFrom.push_back(from);
+	m_PendingTo.push_back(to);
+	m_PendingWeight.push_back(weight);
+	m_EdgeCount++;
+	m_Built = false;
+}
+
+void CSRGraph::insertEdges(const int *from, const int *to, const int *weight, size_t count)
+{
+	// staging grows at most once per batch instead of per edge, still geometrically
+	size_t need = m_PendingFrom.size() + count;
+	if (need > m_PendingFrom.capacity())
+	{
+		need = max(need, m_PendingFrom.capacity() * 2);
+		m_PendingFrom.reserve(need);
+		m_PendingTo.reserve(need);
+		m_PendingWeight.reserve(need);
+	}
+	for (size_t i = 0; i < count; i++)
+		insertEdge(from[i], to[i], weight[i]);
+}
+
+// Delete every from -> to edge, the other edges are staged again and rebuilt lazily
+int CSRGraph::deleteEdge(int from, int to)
+{
+	if (from < 0 || from >= m_Size || to < 0 || to >= m_Size)
+		return 0;
+	build();
+
+	int removed = 0;
+	for (int e = m_OutOffset[from]; e < m_OutOffset[from + 1]; e++)
+		removed += m_OutTarget[e] == to;
+	if (removed == 0)
+		return 0;
+
+	for (int u = 0; u < m_Size; u++)
+	{
+		for (int e = m_OutOffset[u]; e < m_OutOffset[u + 1]; e++)
+		{
+			if (u == from && m_OutTarget[e] == to)
+				continue;
+			m_PendingFrom.push_back(u);
+			m_PendingTo.push_back(m_OutTarget[e]);
+			m_PendingWeight.push_back(m_OutWeight[e]);
+		}
+	}
+	// compacted arrays are emptied, build() only sees the staged edges
+	m_OwnOutOffset.assign(m_Size + 1, 0);
+	m_OwnInOffset.assign(m_Size + 1, 0);
+	vector<int>().swap(m_OwnOutTarget);
+	vector<int>().swap(m_OwnOutWeight);
+	vector<int>().swap(m_OwnInSource);
+	vector<int>().swap(m_OwnInWeight);
+	useOwnArrays();
+	m_EdgeCount -= removed;
+	m_Built = false;
+	return removed;
+}
+
+// Change the weight of every from -> to edge in place, O(out-degree + in-degree)
+int CSRGraph::updateWeight(int from, int to, int weight)
+{
+	if (from < 0 || from >= m_Size || to < 0 || to >= m_Size)
+		return 0;
+	build();
+
+	int changed = 0;
+	for (int e = m_OutOffset[from]; e < m_OutOffset[from + 1]; e++)
+	{
+		if (m_OutTarget[e] == to)
+		{
+			m_OutWeight[e] = weight;
+			changed++;
+		}
+	}
+	for (int e = m_InOffset[to]; e < m_InOffset[to + 1]; e++)
+	{
+		if (m_InSource[e] == from)
+			m_InWeight[e] = weight;
+	}
+	return changed;
+}
+
+// print graph in the perspective of the loaded format
+bool CSRGraph::printGraph(ostream *fout)
+{
+	if (m_Size < 0)
+		return false;
+	build();
+
+	*fout << "========PRINT========" << endl;
+	if (m_Format == 'M')
+	{
+		TextBuffer header;
+		formatMatrixHeader(header, m_Size);
+		fout->write(header.data(), header.size());
+
+		// expand each CSR row into a dense row, the last of parallel edges wins
+		writeRows(*fout, m_Size, [&](int i, TextBuffer &text)
+		{
+			int e = m_OutOffset[i], end = m_OutOffset[i + 1];
+			text.putLabel(i); // row number
+			text.put('\t');
+			for (int j = 0; j < m_Size; j++)
+			{
+				int w = 0;
+				for (; e < end && m_OutTarget[e] == j; e++)
+					w = m_OutWeight[e];
+				text.putInt(w);
+				text.put('\t');
+			}
+			text.put('\n');
+		});
+	}
+	else
+	{
+		writeRows(*fout, m_Size, [&](int i, TextBuffer &text)
+		{
+			text.putLabel(i);
+			// no connected edge
+			if (m_OutOffset[i] == m_OutOffset[i + 1])
+				text.put("->");
+			// connected edge
+			for (int e = m_OutOffset[i]; e < m_OutOffset[i + 1]; e++)
+			{
+				text.put("->(");
+				text.putInt(m_OutTarget[e]);
+				text.put(',');
+				text.putInt(m_OutWeight[e]);
+				text.put(')');
+			}
+			text.put('\n');
+		});
+	}
+	*fout << "=====================\n\n";
+	return true;
+}
@@ -0,0 +1,64 @@
+#ifndef _CSR_H_
+#define _CSR_H_
+
+#include "Graph.h"
+
+class MappedFile;
+
+// Compressed Sparse Row graph
+// forward index (out-edges) and transposed index (in-edges) are kept in contiguous arrays
+// the arrays are owned vectors, or live in a mapped graph file (attach) until the first structural change
+class CSRGraph : public Graph
+{
+private:
+	char m_Format; // input format the graph was loaded from ('L' or 'M'), used by printGraph
+	bool m_Built;  // false while staged edges are not yet compacted
+
+	// edges staged by insertEdge until build()
+	vector<int> m_PendingFrom;
+	vector<int> m_PendingTo;
+	vector<int> m_PendingWeight;
+
+	// out-edges of v : [m_OutOffset[v], m_OutOffset[v + 1]), sorted by target
+	int *m_OutOffset;
+	int *m_OutTarget;
+	int *m_OutWeight;
+
+	// in-edges of v : [m_InOffset[v], m_InOffset[v + 1]), sorted by source
+	int *m_InOffset;
+	int *m_InSource;
+	int *m_InWeight;
+
+	// storage behind the arrays above when they are not mapped
+	vector<int> m_OwnOutOffset;
+	vector<int> m_OwnOutTarget;
+	vector<int> m_OwnOutWeight;
+	vector<int> m_OwnInOffset;
+	vector<int> m_OwnInSource;
+	vector<int> m_OwnInWeight;
+
+	MappedFile *m_Mapping; // file the arrays point into, nullptr when owned
+
+	void useOwnArrays(); // arrays onto the owned vectors, the mapping is released
+
+public:
+	CSRGraph(bool type, int size, char format);
+	~CSRGraph();
+
+	void build();
+	// serves the arrays straight from a mapped graph file and takes the mapping over
+	// in* may be nullptr, the reverse index is then built in memory
+	void attach(MappedFile *mapping, int edgeCount, int *outOffset, int *outTarget, int *outWeight, int *inOffset, int *inSource, int *inWeight);
+	char getFormat() { return m_Format; }
+
+	void getAdjacentEdges(int vertex, multimap<int, int> *m);
+	void getAdjacentEdgesDirect(int vertex, multimap<int, int> *m);
+	void insertEdge(int from, int to, int weight);
+	void insertEdges(const int *from, const int *to, const int *weight, size_t count);
+	int deleteEdge(int from, int to);
+	int updateWeight(int from, int to, int weight);
+	bool printGraph(ostream *fout);
+	void visitEdges(int vertex, EdgeDirection dir, EdgeVisitor visit, void *context);
+};
+
+#endif
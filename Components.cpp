@@ -0,0 +1,127 @@
+#include "Components.h"
+#include "MST.h"
+
+ComponentIndex::ComponentIndex()
+{
+	m_WeakCount = 0;
+	m_StrongCount = 0;
+}
+
+void ComponentIndex::clear()
+{
+	vector<int>().swap(m_Weak);
+	vector<int>().swap(m_Strong);
+	vector<char>().swap(m_WeakNegative);
+	vector<char>().swap(m_CycleNegative);
+	m_WeakCount = 0;
+	m_StrongCount = 0;
+}
+
+void ComponentIndex::build(Graph *graph)
+{
+	int size = graph->getSize();
+	clear();
+	if (size <= 0)
+		return;
+
+	// out-edges once in CSR form, shared by both passes
+	vector<int> offset(size + 1, 0), target;
+	vector<char> negative; // per edge, weight < 0
+	for (int u = 0; u < size; u++)
+	{
+		graph->forEachEdge(u, EDGE_OUT, [&](int v, int w)
+		{
+			target.push_back(v);
+			negative.push_back(w < 0);
+		});
+		offset[u + 1] = (int)target.size();
+	}
+
+	// weak components, labels in order of the smallest vertex
+	DisjointSet sets(size);
+	for (int u = 0; u < size; u++)
+	{
+		for (int i = offset[u]; i < offset[u + 1]; i++)
+			sets.merge(u, target[i]);
+	}
+	m_Weak.assign(size, -1);
+	vector<int> label(size, -1);
+	for (int v = 0; v < size; v++)
+	{
+		int root = sets.find(v);
+		if (label[root] == -1)
+			label[root] = m_WeakCount++;
+		m_Weak[v] = label[root];
+	}
+
+	// strong components, Tarjan with an explicit call stack
+	vector<int> index(size, -1), low(size, 0), next(size, 0);
+	vector<char> onStack(size, 0);
+	vector<int> stack, calls;
+	int counter = 0;
+	m_Strong.assign(size, -1);
+	for (int root = 0; root < size; root++)
+	{
+		if (index[root] != -1)
+			continue;
+		index[root] = low[root] = counter++;
+		next[root] = offset[root];
+		stack.push_back(root);
+		onStack[root] = 1;
+		calls.push_back(root);
+
+		while (!calls.empty())
+		{
+			int v = calls.back();
+			if (next[v] < offset[v + 1])
+			{
+				// next edge of v : descend into new vertices, back edges lower low[v]
+				int w = target[next[v]++];
+				if (index[w] == -1)
+				{
+					index[w] = low[w] = counter++;
+					next[w] = offset[w];
+					stack.push_back(w);
+					onStack[w] = 1;
+					calls.push_back(w);
+				}
+				else if (onStack[w])
+					low[v] = min(low[v], index[w]);
+				continue;
+			}
+
+			// v is finished
+			calls.pop_back();
+			if (!calls.empty())
+				low[calls.back()] = min(low[calls.back()], low[v]);
+			if (low[v] == index[v])
+			{
+				// v is the root of a component, pop it off
+				int w;
+				do
+				{
+					w = stack.back();
+					stack.pop_back();
+					onStack[w] = 0;
+					m_Strong[w] = m_StrongCount;
+				} while (w != v);
+				m_StrongCount++;
+			}
+		}
+	}
+
+	// negative edges per weak component, a directed negative cycle needs one inside a strong component
+	m_WeakNegative.assign(m_WeakCount, 0);
+	m_CycleNegative.assign(m_WeakCount, 0);
+	for (int u = 0; u < size; u++)
+	{
+		for (int i = offset[u]; i < offset[u + 1]; i++)
+		{
+			if (!negative[i])
+				continue;
+			m_WeakNegative[m_Weak[u]] = 1;
+			if (m_Strong[u] == m_Strong[target[i]])
+				m_CycleNegative[m_Weak[u]] = 1;
+		}
+	}
+}
@@ -0,0 +1,46 @@
+#ifndef _COMPONENTS_H_
+#define _COMPONENTS_H_
+
+#include "Graph.h"
+
+// Component labels of one loaded graph, built once after LOAD
+// weak   : components of the undirected view (Union-Find)
+// strong : strongly connected components of the directed view (iterative Tarjan),
+//          numbered in reverse topological order so s -> t needs strong(s) >= strong(t)
+class ComponentIndex
+{
+private:
+	vector<int> m_Weak;			 // weak component of every vertex, 0 .. m_WeakCount - 1
+	vector<int> m_Strong;		 // strong component of every vertex, 0 .. m_StrongCount - 1
+	vector<char> m_WeakNegative; // weak component holds a negative edge
+	vector<char> m_CycleNegative; // weak component holds a negative edge inside one strong component
+	int m_WeakCount;
+	int m_StrongCount;
+
+public:
+	ComponentIndex();
+
+	void build(Graph *graph);
+	void clear();
+
+	int getWeakCount() { return m_WeakCount; }
+	int getStrongCount() { return m_StrongCount; }
+	int weak(int v) { return m_Weak[v]; }
+	int strong(int v) { return m_Strong[v]; }
+
+	// true if t certainly can not be reached from s, O(1)
+	// option 'O' directed, otherwise undirected
+	bool unreachable(char option, int s, int t)
+	{
+		return m_Weak[s] != m_Weak[t] || (option == 'O' && m_Strong[s] < m_Strong[t]);
+	}
+	// true if the component of v holds a negative edge, a negative cycle in the undirected view
+	bool hasNegative(int v) { return m_WeakNegative[m_Weak[v]] != 0; }
+	// true if no negative cycle can be reached from s
+	bool negativeCycleFree(char option, int s)
+	{
+		return !(option == 'O' ? m_CycleNegative : m_WeakNegative)[m_Weak[s]];
+	}
+};
+
+#endif
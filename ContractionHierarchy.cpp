@@ -0,0 +1,331 @@
+#include "ContractionHierarchy.h"
+#include <chrono>
+
+// settled vertex limit of one witness search, a failed search only adds a redundant shortcut
+const int WITNESS_SETTLE_LIMIT = 500;
+
+// Mutable graph used while contracting vertices
+class Contractor
+{
+public:
+	struct WorkArc
+	{
+		int to;
+		int weight;
+	};
+
+	vector<vector<WorkArc>> out; // u -> to
+	vector<vector<WorkArc>> in;  // to <- u, WorkArc.to = u
+	vector<bool> contracted;
+	vector<int> deleted; // contracted neighbor count, part of the priority
+	unordered_map<long long, int> &middle;
+
+	// witness search workspace
+	vector<int> dist;
+	vector<int> touched;
+	IndexedHeap heap;
+
+	Contractor(int size, unordered_map<long long, int> &middleMap) : middle(middleMap), heap(size)
+	{
+		out.resize(size);
+		in.resize(size);
+		contracted.assign(size, false);
+		deleted.assign(size, 0);
+		dist.assign(size, INF);
+	}
+
+	static long long key(int from, int to) { return ((long long)from << 32) | (unsigned)to; }
+
+	// keep only the lightest arc per (from, to) pair
+	void addArc(int from, int to, int weight, int mid)
+	{
+		for (size_t i = 0; i < out[from].size(); i++)
+		{
+			if (out[from][i].to != to)
+				continue;
+			if (weight < out[from][i].weight)
+			{
+				out[from][i].weight = weight;
+				for (size_t j = 0; j < in[to].size(); j++)
+				{
+					if (in[to][j].to == from)
+						in[to][j].weight = weight;
+				}
+				middle[key(from, to)] = mid;
+			}
+			return;
+		}
+		WorkArc arc;
+		arc.to = to;
+		arc.weight = weight;
+		out[from].push_back(arc);
+		arc.to = from;
+		in[to].push_back(arc);
+		middle[key(from, to)] = mid;
+	}
+
+	// local Dijkstra from source avoiding skip and contracted vertices, up to distance limit
+	void witnessSearch(int source, int skip, int limit)
+	{
+		for (size_t i = 0; i < touched.size(); i++)
+			dist[touched[i]] = INF;
+		touched.clear();
+		heap.clear();
+
+		dist[source] = 0;
+		touched.push_back(source);
+		heap.push(source, 0);
+		int settled = 0;
+		while (!heap.empty() && settled < WITNESS_SETTLE_LIMIT)
+		{
+			int u = heap.pop();
+			if (dist[u] > limit)
+				break;
+			settled++;
+			for (size_t i = 0; i < out[u].size(); i++)
+			{
+				int v = out[u][i].to;
+				int nd = dist[u] + out[u][i].weight;
+				if (v == skip || contracted[v] || dist[v] <= nd)
+					continue;
+				if (dist[v] == INF)
+					touched.push_back(v);
+				dist[v] = nd;
+				heap.push(v, nd);
+			}
+		}
+	}
+
+	// shortcuts needed to remove v, inserted when apply is true
+	int contract(int v, bool apply)
+	{
+		int shortcuts = 0;
+		int maxOut = 0;
+		for (size_t j = 0; j < out[v].size(); j++)
+		{
+			if (!contracted[out[v][j].to] && out[v][j].weight > maxOut)
+				maxOut = out[v][j].weight;
+		}
+
+		for (size_t i = 0; i < in[v].size(); i++)
+		{
+			int u = in[v][i].to;
+			int wu = in[v][i].weight;
+			if (contracted[u] || u == v)
+				continue;
+
+			witnessSearch(u, v, wu + maxOut);
+			for (size_t j = 0; j < out[v].size(); j++)
+			{
+				int w = out[v][j].to;
+				if (contracted[w] || w == v || w == u)
+					continue;
+				int through = wu + out[v][j].weight;
+				// no path avoiding v is as short : shortcut u -> w
+				if (dist[w] > through)
+				{
+					shortcuts++;
+					if (apply)
+						addArc(u, w, through, v);
+				}
+			}
+		}
+		return shortcuts;
+	}
+
+	// edge difference plus contracted neighbors, smaller is contracted first
+	int priority(int v)
+	{
+		int removed = 0;
+		for (size_t i = 0; i < out[v].size(); i++)
+			removed += contracted[out[v][i].to] ? 0 : 1;
+		for (size_t i = 0; i < in[v].size(); i++)
+			removed += contracted[in[v][i].to] ? 0 : 1;
+		return contract(v, false) - removed + deleted[v];
+	}
+};
+
+ContractionHierarchy::ContractionHierarchy(Graph *graph, char option) : m_Forward(graph->getSize()), m_Backward(graph->getSize())
+{
+	m_Option = option;
+	m_Size = graph->getSize();
+	for (int side = 0; side < 2; side++)
+	{
+		m_Dist[side].assign(m_Size, INF);
+		m_Parent[side].assign(m_Size, -1);
+	}
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	build(graph);
+	m_BuildMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+void ContractionHierarchy::build(Graph *graph)
+{
+	Contractor c(m_Size, m_Middle);
+	for (int u = 0; u < m_Size; u++)
+	{
+		graph->forEachNeighbor(u, m_Option, [&](int v, int w)
+		{
+			if (u != v)
+				c.addArc(u, v, w, -1);
+		});
+	}
+
+	// lazy node ordering : a popped vertex is contracted only if its priority is still minimal
+	priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> order;
+	for (int v = 0; v < m_Size; v++)
+		order.push(make_pair(c.priority(v), v));
+
+	m_Rank.assign(m_Size, 0);
+	int next = 0;
+	while (!order.empty())
+	{
+		int v = order.top().second;
+		order.pop();
+		if (c.contracted[v])
+			continue;
+
+		int priority = c.priority(v);
+		if (!order.empty() && priority > order.top().first)
+		{
+			order.push(make_pair(priority, v));
+			continue;
+		}
+
+		c.contract(v, true);
+		c.contracted[v] = true;
+		m_Rank[v] = next++;
+		for (size_t i = 0; i < c.out[v].size(); i++)
+			c.deleted[c.out[v][i].to]++;
+		for (size_t i = 0; i < c.in[v].size(); i++)
+			c.deleted[c.in[v][i].to]++;
+	}
+
+	// split every arc into the upward (forward) and downward (backward) search graphs
+	m_Up.assign(m_Size, vector<Arc>());
+	m_Down.assign(m_Size, vector<Arc>());
+	for (int u = 0; u < m_Size; u++)
+	{
+		for (size_t i = 0; i < c.out[u].size(); i++)
+		{
+			Arc arc;
+			arc.weight = c.out[u][i].weight;
+			int w = c.out[u][i].to;
+			if (m_Rank[w] > m_Rank[u])
+			{
+				arc.to = w;
+				m_Up[u].push_back(arc);
+			}
+			else
+			{
+				arc.to = u;
+				m_Down[w].push_back(arc);
+			}
+		}
+	}
+
+	m_Shortcuts = 0;
+	for (unordered_map<long long, int>::iterator it = m_Middle.begin(); it != m_Middle.end(); it++)
+	{
+		if (it->second != -1)
+			m_Shortcuts++;
+	}
+}
+
+// append the original vertices of hierarchy arc from -> to (from itself excluded)
+void ContractionHierarchy::unpack(int from, int to, vector<int> &path)
+{
+	vector<pair<int, int>> pending(1, make_pair(from, to));
+	while (!pending.empty())
+	{
+		pair<int, int> arc = pending.back();
+		pending.pop_back();
+		int mid = m_Middle[arcKey(arc.first, arc.second)];
+		if (mid == -1)
+		{
+			path.push_back(arc.second);
+		}
+		else
+		{
+			// first half is expanded first
+			pending.push_back(make_pair(mid, arc.second));
+			pending.push_back(make_pair(arc.first, mid));
+		}
+	}
+}
+
+void ContractionHierarchy::query(int s, int t, int &cost, vector<int> &path)
+{
+	// forget the previous query
+	for (size_t i = 0; i < m_Touched.size(); i++)
+	{
+		int v = m_Touched[i];
+		m_Dist[0][v] = m_Dist[1][v] = INF;
+		m_Parent[0][v] = m_Parent[1][v] = -1;
+	}
+	m_Touched.clear();
+	m_Forward.clear();
+	m_Backward.clear();
+	path.clear();
+
+	IndexedHeap *heap[2] = {&m_Forward, &m_Backward};
+	vector<vector<Arc>> *arcs[2] = {&m_Up, &m_Down};
+
+	m_Dist[0][s] = 0;
+	m_Dist[1][t] = 0;
+	m_Touched.push_back(s);
+	m_Touched.push_back(t);
+	m_Forward.push(s, 0);
+	m_Backward.push(t, 0);
+
+	int best = INF;
+	int meet = -1;
+	while (true)
+	{
+		// a side whose closest vertex is not below best is finished
+		bool forward = !m_Forward.empty() && m_Forward.topKey() < best;
+		bool backward = !m_Backward.empty() && m_Backward.topKey() < best;
+		if (!forward && !backward)
+			break;
+		int side = forward && (!backward || m_Forward.topKey() <= m_Backward.topKey()) ? 0 : 1;
+
+		int u = heap[side]->pop();
+		if (m_Dist[1 - side][u] != INF && m_Dist[0][u] + m_Dist[1][u] < best)
+		{
+			best = m_Dist[0][u] + m_Dist[1][u];
+			meet = u;
+		}
+
+		// upward arcs only
+		vector<Arc> &list = (*arcs[side])[u];
+		for (size_t i = 0; i < list.size(); i++)
+		{
+			int v = list[i].to;
+			int nd = m_Dist[side][u] + list[i].weight;
+			if (m_Dist[side][v] <= nd)
+				continue;
+			if (m_Dist[0][v] == INF && m_Dist[1][v] == INF)
+				m_Touched.push_back(v);
+			m_Dist[side][v] = nd;
+			m_Parent[side][v] = u;
+			heap[side]->push(v, nd);
+		}
+	}
+
+	cost = best;
+	if (best == INF)
+		return;
+
+	// hierarchy vertices s ... meet ... t
+	vector<int> corridor;
+	for (int v = meet; v != -1; v = m_Parent[0][v])
+		corridor.push_back(v);
+	reverse(corridor.begin(), corridor.end());
+	for (int v = m_Parent[1][meet]; v != -1; v = m_Parent[1][v])
+		corridor.push_back(v);
+
+	path.push_back(s);
+	for (size_t i = 0; i + 1 < corridor.size(); i++)
+		unpack(corridor[i], corridor[i + 1], path);
+}
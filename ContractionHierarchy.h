@@ -0,0 +1,53 @@
+#ifndef _CONTRACTIONHIERARCHY_H_
+#define _CONTRACTIONHIERARCHY_H_
+
+#include "Graph.h"
+#include "PriorityQueue.h"
+#include <unordered_map>
+
+// Contraction hierarchy over a loaded graph with non-negative weights
+// vertices are contracted in edge difference order, shortcuts keep every shortest path distance
+// queries run a bidirectional Dijkstra restricted to upward edges and unpack the shortcuts
+class ContractionHierarchy
+{
+private:
+	struct Arc
+	{
+		int to;
+		int weight;
+	};
+
+	char m_Option;     // 'O' directed, otherwise undirected
+	int m_Size;
+	int m_Shortcuts;   // shortcuts added by the contraction
+	double m_BuildMs;  // preprocessing time
+	vector<int> m_Rank; // contraction order
+
+	vector<vector<Arc>> m_Up;   // u -> w with rank[w] > rank[u]
+	vector<vector<Arc>> m_Down; // at u : x -> u with rank[x] > rank[u], Arc.to = x
+	unordered_map<long long, int> m_Middle; // (from, to) -> contracted vertex of a shortcut, -1 for an original edge
+
+	// query workspace, reset through m_Touched
+	vector<int> m_Dist[2];
+	vector<int> m_Parent[2];
+	IndexedHeap m_Forward;
+	IndexedHeap m_Backward;
+	vector<int> m_Touched;
+
+	static long long arcKey(int from, int to) { return ((long long)from << 32) | (unsigned)to; }
+	void build(Graph *graph);
+	void unpack(int from, int to, vector<int> &path);
+
+public:
+	ContractionHierarchy(Graph *graph, char option);
+
+	char getOption() { return m_Option; }
+	int getSize() { return m_Size; }
+	int getShortcutCount() { return m_Shortcuts; }
+	double getBuildTime() { return m_BuildMs; }
+
+	// cost = INF if t is unreachable, path from s to t otherwise
+	void query(int s, int t, int &cost, vector<int> &path);
+};
+
+#endif
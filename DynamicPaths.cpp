@@ -0,0 +1,228 @@
+#include "DynamicPaths.h"
+
+int connectionWeight(Graph *graph, char option, int u, int v)
+{
+	int best = INF;
+	graph->forEachEdgeUntil(u, option == 'O' ? EDGE_OUT : EDGE_BOTH, [&](int x, int w) -> bool
+	{
+		if (x == v && w < best)
+			best = w;
+		return x <= v; // ascending neighbors, nothing after v
+	});
+	return best;
+}
+
+TreeRepair::TreeRepair(int size) : m_Heap(size)
+{
+	m_CutMark.assign(size, 0);
+	m_TouchMark.assign(size, 0);
+	m_Round = 0;
+}
+
+void TreeRepair::touch(int v)
+{
+	if (m_TouchMark[v] == m_Round)
+		return;
+	m_TouchMark[v] = m_Round;
+	m_Touched.push_back(v);
+}
+
+// collects the subtree below the u -> v tree edge if that edge is no longer tight
+void TreeRepair::cut(Graph *graph, char option, int u, int v, const int *dist, const int *parent)
+{
+	if (parent[v] != u || m_CutMark[v] == m_Round)
+		return;
+	int w = connectionWeight(graph, option, u, v);
+	if (w != INF && dist[u] + w <= dist[v])
+		return;
+
+	size_t first = m_Cut.size();
+	m_CutMark[v] = m_Round;
+	m_Cut.push_back(v);
+	// children are the neighbors whose parent is the current vertex
+	for (size_t i = first; i < m_Cut.size(); i++)
+	{
+		int x = m_Cut[i];
+		graph->forEachNeighbor(x, option, [&](int z, int)
+		{
+			if (parent[z] == x && m_CutMark[z] != m_Round)
+			{
+				m_CutMark[z] = m_Round;
+				m_Cut.push_back(z);
+			}
+		});
+	}
+}
+
+void TreeRepair::repair(Graph *graph, char option, int source, int from, int to, int *dist, int *parent)
+{
+	m_Round++;
+	m_Cut.clear();
+	m_Touched.clear();
+	m_Heap.clear();
+	EdgeDirection backward = option == 'O' ? EDGE_IN : EDGE_BOTH;
+
+	// heavier or deleted tree edge, both orientations in the undirected view
+	cut(graph, option, from, to, dist, parent);
+	if (option != 'O')
+		cut(graph, option, to, from, dist, parent);
+	for (size_t i = 0; i < m_Cut.size(); i++)
+		dist[m_Cut[i]] = INF;
+
+	// seeds : cut vertices and the endpoints of the changed edge, from their intact in-neighbors
+	vector<int> &seeds = m_Cut;
+	seeds.push_back(to);
+	if (option != 'O')
+		seeds.push_back(from);
+	for (size_t i = 0; i < seeds.size(); i++)
+	{
+		int x = seeds[i];
+		touch(x);
+		if (x == source)
+			continue;
+		int best = INF;
+		graph->forEachEdge(x, backward, [&](int y, int w)
+		{
+			if (dist[y] != INF && dist[y] + w < best)
+				best = dist[y] + w;
+		});
+		if (best < dist[x])
+		{
+			dist[x] = best;
+			m_Heap.push(x, best);
+		}
+	}
+
+	// Dijkstra restricted to the vertices whose distance changes
+	while (!m_Heap.empty())
+	{
+		int x = m_Heap.pop();
+		graph->forEachNeighbor(x, option, [&](int z, int w)
+		{
+			touch(z); // a changed neighbor may become its new parent
+			if (dist[x] + w < dist[z])
+			{
+				dist[z] = dist[x] + w;
+				m_Heap.push(z, dist[z]);
+			}
+		});
+	}
+
+	for (size_t i = 0; i < m_Touched.size(); i++)
+		parent[m_Touched[i]] = tightParent(graph, option, source, dist, m_Touched[i]);
+}
+
+bool updateTree(Graph *graph, char option, int source, const EdgeChange &change, SSSPTree &tree, TreeRepair &repair)
+{
+	if (!change.positive || !tree.valid)
+		return false;
+	int k = option == 'O' ? 0 : 1;
+	if (change.before[k] != change.after[k])
+		repair.repair(graph, option, source, change.from, change.to, &tree.dist[0], &tree.parent[0]);
+	return true;
+}
+
+// Relaxes every pair through the new u -> v edge of weight w, d[i][j] = d[i][u] + w + d[v][j]
+// row v and column u never change without a negative cycle, so rows are updated in parallel and in place
+// returns false if the edge closes a negative cycle
+static bool insertArc(Graph *graph, char option, APSPEntry &entry, int u, int v, int w)
+{
+	DistanceMatrix &dist = entry.dist;
+	int size = dist.getSize();
+	const int *rowV = dist.row(v);
+	if (rowV[u] != INF && rowV[u] + w < 0)
+		return false;
+
+	int workers = workerCount();
+	vector<vector<int>> changed(workers), mark(workers);
+	parallelFor(0, size, [&](int i, int worker)
+	{
+		int *row = dist.row(i);
+		if (row[u] == INF || row[u] + w > row[v])
+			return;
+		int base = row[u] + w;
+		vector<int> &list = changed[worker];
+		list.clear();
+		if (base < row[v])
+		{
+			for (int j = 0; j < size; j++)
+			{
+				if (rowV[j] != INF && base + rowV[j] < row[j])
+				{
+					row[j] = base + rowV[j];
+					list.push_back(j);
+				}
+			}
+		}
+		if (!entry.hasParent)
+			return;
+
+		// parents of v, of the changed cells and of their neighbors, each once per row
+		vector<int> &seen = mark[worker];
+		if (seen.empty())
+			seen.assign(size, -1);
+		int *parent = &entry.parent[(size_t)i * size];
+		auto fix = [&](int x)
+		{
+			if (seen[x] == i)
+				return;
+			seen[x] = i;
+			parent[x] = tightParent(graph, option, i, row, x);
+		};
+		fix(v);
+		for (size_t k = 0; k < list.size(); k++)
+		{
+			fix(list[k]);
+			graph->forEachNeighbor(list[k], option, [&](int z, int) { fix(z); });
+		}
+	});
+	return true;
+}
+
+bool updateAllPairs(Graph *graph, char option, const EdgeChange &change, APSPEntry &entry)
+{
+	int k = option == 'O' ? 0 : 1;
+	int before = change.before[k], after = change.after[k];
+	if (before == after)
+		return true;
+
+	if (after < before)
+	{
+		// a lighter edge never removes a negative cycle
+		if (!entry.valid)
+			return true;
+		if (!change.positive)
+		{
+			entry.hasParent = false;
+			vector<int>().swap(entry.parent);
+		}
+		entry.range.minWeight = entry.range.hasEdge ? min(entry.range.minWeight, after) : after;
+		entry.range.maxWeight = entry.range.hasEdge ? max(entry.range.maxWeight, after) : after;
+		entry.range.hasEdge = true;
+
+		bool valid = insertArc(graph, option, entry, change.from, change.to, after);
+		if (valid && option != 'O' && change.from != change.to)
+			valid = insertArc(graph, option, entry, change.to, change.from, after);
+		if (!valid)
+		{
+			entry.valid = false;
+			entry.hasParent = false;
+			vector<int>().swap(entry.parent);
+		}
+		return true;
+	}
+
+	// heavier or deleted : rows are repaired through their parent trees
+	if (!entry.valid || !entry.hasParent || !change.positive)
+		return false;
+	if (after != INF)
+		entry.range.maxWeight = max(entry.range.maxWeight, after);
+
+	int size = entry.dist.getSize();
+	vector<TreeRepair> repair(workerCount(), TreeRepair(size));
+	parallelFor(0, size, [&](int s, int worker)
+	{
+		repair[worker].repair(graph, option, s, change.from, change.to, entry.dist.row(s), &entry.parent[(size_t)s * size]);
+	});
+	return true;
+}
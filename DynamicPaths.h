@@ -0,0 +1,54 @@
+#ifndef _DYNAMIC_PATHS_H_
+#define _DYNAMIC_PATHS_H_
+
+#include "APSP.h"
+#include "PriorityQueue.h"
+
+// Weight of the lightest u -> v edge, INF if none
+// option 'O' directed, otherwise u -> v and v -> u both count
+int connectionWeight(Graph *graph, char option, int u, int v);
+
+// One in-place edge change, the from - to connection weighed before and after it
+struct EdgeChange
+{
+	int from;
+	int to;
+	int before[2];	// connectionWeight before the change ([0] 'O', [1] otherwise)
+	int after[2];	// connectionWeight after the change
+	bool positive;	// every weight > 0 before and after the change
+};
+
+// Ramalingam-Reps repair of a shortest path tree after one connection changed
+// the tree must have tightParents() parents and every weight must stay > 0
+// heavier / deleted tree edge : its subtree is cut off and reattached by a Dijkstra over the cut vertices
+// lighter / new edge : a Dijkstra from its head spreads the shorter distances
+// only changed vertices and their neighbors are visited, O(V) workspace reused between calls
+class TreeRepair
+{
+private:
+	IndexedHeap m_Heap;
+	vector<int> m_CutMark;	 // == m_Round : vertex cut off this round
+	vector<int> m_TouchMark; // == m_Round : parent is recomputed this round
+	vector<int> m_Cut;
+	vector<int> m_Touched;
+	int m_Round;
+
+	void cut(Graph *graph, char option, int u, int v, const int *dist, const int *parent);
+	void touch(int v);
+
+public:
+	TreeRepair(int size);
+
+	void repair(Graph *graph, char option, int source, int from, int to, int *dist, int *parent);
+};
+
+// Brings a cached tree of option up to date, false if it has to be dropped
+// (weights not all positive, or a failed Bellman-Ford run)
+bool updateTree(Graph *graph, char option, int source, const EdgeChange &change, SSSPTree &tree, TreeRepair &repair);
+
+// Brings a cached all-pairs entry of option up to date, false if it has to be recomputed
+// lighter / new connection : O(V^2) relaxation through the new edge, parents fixed around changed cells
+// heavier / deleted connection : TreeRepair on every row, needs the parent matrix
+bool updateAllPairs(Graph *graph, char option, const EdgeChange &change, APSPEntry &entry);
+
+#endif
@@ -4,6 +4,7 @@ Graph::Graph(bool type, int size)
 {
 	m_Type = type;
 	m_Size = size;
+	m_EdgeCount = 0;
 }
 
 Graph::~Graph()	
@@ -13,4 +14,11 @@ Graph::~Graph()
 
 
 bool Graph::getType(){return m_Type;}	
-int Graph::getSize(){return m_Size;}
\ No newline at end of file
+int Graph::getSize(){return m_Size;}
+int Graph::getEdgeCount(){return m_EdgeCount;}
+
+void Graph::insertEdges(const int *from, const int *to, const int *weight, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		insertEdge(from[i], to[i], weight[i]);
+}
\ No newline at end of file
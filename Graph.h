@@ -16,11 +16,27 @@
 
 using namespace std;
 
+// Used to Initialize Shortest Path Algorithm
+const int INF = 100000000;
+
+// Which edges of a vertex are visited by visitEdges
+enum EdgeDirection
+{
+	EDGE_OUT, // out-degree edges, directed perspective
+	EDGE_IN,  // in-degree edges
+	EDGE_BOTH // out-degree and in-degree edges, undirected perspective
+};
+
+// Called once per visited edge with (context, neighbor vertex, weight)
+// returning false stops the visit early
+typedef bool (*EdgeVisitor)(void *context, int neighbor, int weight);
+
 class Graph
 {
 protected:
 	bool m_Type;
 	int m_Size;
+	int m_EdgeCount; // number of stored directed edges, kept by insertEdge
 
 public:
 	Graph(bool type, int size);
@@ -28,11 +44,57 @@ public:
 
 	bool getType();
 	int getSize();
+	int getEdgeCount();
 
 	virtual void getAdjacentEdges(int vertex, multimap<int, int> *m) = 0;
 	virtual void getAdjacentEdgesDirect(int vertex, multimap<int, int> *m) = 0;
 	virtual void insertEdge(int from, int to, int weight) = 0;
-	virtual bool printGraph(ofstream *fout) = 0;
+	// insertEdge for count edges in order, overridden where a batch can be stored at once
+	virtual void insertEdges(const int *from, const int *to, const int *weight, size_t count);
+	// removes every from -> to edge, returns how many were removed
+	virtual int deleteEdge(int from, int to) = 0;
+	// sets the weight of every from -> to edge, returns how many were changed
+	virtual int updateWeight(int from, int to, int weight) = 0;
+	virtual bool printGraph(ostream *fout) = 0;
+
+	// Allocation-free neighbor iteration, neighbors come in ascending vertex order
+	virtual void visitEdges(int vertex, EdgeDirection dir, EdgeVisitor visit, void *context) = 0;
+
+	// f(neighbor, weight) for every edge of vertex in the given direction
+	template <class F>
+	void forEachEdge(int vertex, EdgeDirection dir, F f)
+	{
+		visitEdges(vertex, dir, &Graph::callVisitor<F>, &f);
+	}
+
+	// option 'O' : out-degree edges only, otherwise undirected neighbors
+	template <class F>
+	void forEachNeighbor(int vertex, char option, F f)
+	{
+		visitEdges(vertex, option == 'O' ? EDGE_OUT : EDGE_BOTH, &Graph::callVisitor<F>, &f);
+	}
+
+	// bool f(neighbor, weight), the visit stops at the first false
+	template <class F>
+	void forEachEdgeUntil(int vertex, EdgeDirection dir, F f)
+	{
+		visitEdges(vertex, dir, &Graph::callVisitorUntil<F>, &f);
+	}
+
+private:
+	// adapts a callable object to the EdgeVisitor signature
+	template <class F>
+	static bool callVisitor(void *context, int neighbor, int weight)
+	{
+		(*(F *)context)(neighbor, weight);
+		return true;
+	}
+
+	template <class F>
+	static bool callVisitorUntil(void *context, int neighbor, int weight)
+	{
+		return (*(F *)context)(neighbor, weight);
+	}
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,196 @@
+#include "GraphFile.h"
+#include "CSRGraph.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+MappedFile::MappedFile()
+{
+	m_Data = nullptr;
+	m_Size = 0;
+}
+
+MappedFile::~MappedFile()
+{
+	unmap();
+}
+
+bool MappedFile::map(const char *filename)
+{
+	unmap();
+	int fd = open(filename, O_RDONLY);
+	if (fd < 0)
+		return false;
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size <= 0)
+	{
+		close(fd);
+		return false;
+	}
+	// MAP_PRIVATE : UPDATE_WEIGHT may write into the arrays, the file itself never changes
+	void *data = mmap(nullptr, info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd); // the mapping keeps the file alive
+	if (data == MAP_FAILED)
+		return false;
+	m_Data = data;
+	m_Size = info.st_size;
+	return true;
+}
+
+void MappedFile::unmap()
+{
+	if (m_Data != nullptr)
+		munmap(m_Data, m_Size);
+	m_Data = nullptr;
+	m_Size = 0;
+}
+
+static bool writeArray(FILE *file, const vector<int> &values)
+{
+	// an empty vector may have no storage at all
+	return values.empty() || fwrite(values.data(), sizeof(int), values.size(), file) == values.size();
+}
+
+// offsets start at 0, never decrease and end at edges, every neighbor is a vertex
+static bool validIndex(const int *offset, const int *neighbor, long long vertices, long long edges)
+{
+	if (offset[0] != 0 || offset[vertices] != edges)
+		return false;
+	for (long long v = 0; v < vertices; v++)
+	{
+		if (offset[v] > offset[v + 1])
+			return false;
+	}
+	for (long long e = 0; e < edges; e++)
+	{
+		if (neighbor[e] < 0 || neighbor[e] >= vertices)
+			return false;
+	}
+	return true;
+}
+
+bool saveGraphFile(Graph *graph, char format, const char *filename, bool reverse)
+{
+	int size = graph->getSize();
+
+	// forward index, visitEdges already yields targets in ascending order
+	vector<int> outOffset(size + 1, 0);
+	vector<int> outTarget;
+	vector<int> outWeight;
+	outTarget.reserve(graph->getEdgeCount());
+	outWeight.reserve(graph->getEdgeCount());
+	for (int u = 0; u < size; u++)
+	{
+		graph->forEachEdge(u, EDGE_OUT, [&](int v, int w)
+		{
+			outTarget.push_back(v);
+			outWeight.push_back(w);
+		});
+		outOffset[u + 1] = (int)outTarget.size();
+	}
+	int edges = (int)outTarget.size();
+
+	GraphFileHeader header;
+	memcpy(header.magic, GRAPH_FILE_MAGIC, 4);
+	header.byteOrder = GRAPH_FILE_BYTE_ORDER;
+	header.version = GRAPH_FILE_VERSION;
+	header.flags = reverse ? GRAPH_FILE_REVERSE : 0;
+	header.format = format;
+	header.vertices = size;
+	header.edges = edges;
+	header.reserved = 0;
+
+	// written aside and renamed, a graph mapped from filename keeps reading the old file
+	string temp = string(filename) + ".tmp";
+	FILE *file = fopen(temp.c_str(), "wb");
+	if (file == nullptr)
+		return false;
+	bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+	ok = ok && writeArray(file, outOffset) && writeArray(file, outTarget) && writeArray(file, outWeight);
+
+	if (reverse)
+	{
+		// in-edge index : stable counting sort of the (from, to) ordered edges by target
+		vector<int> inOffset(size + 1, 0);
+		for (int e = 0; e < edges; e++)
+			inOffset[outTarget[e] + 1]++;
+		for (int v = 0; v < size; v++)
+			inOffset[v + 1] += inOffset[v];
+		vector<int> pos(inOffset.begin(), inOffset.end() - 1);
+		vector<int> inSource(edges);
+		vector<int> inWeight(edges);
+		for (int u = 0; u < size; u++)
+		{
+			for (int e = outOffset[u]; e < outOffset[u + 1]; e++)
+			{
+				int slot = pos[outTarget[e]]++;
+				inSource[slot] = u;
+				inWeight[slot] = outWeight[e];
+			}
+		}
+		ok = ok && writeArray(file, inOffset) && writeArray(file, inSource) && writeArray(file, inWeight);
+	}
+
+	if (fclose(file) != 0)
+		ok = false;
+	if (!ok || rename(temp.c_str(), filename) != 0)
+	{
+		remove(temp.c_str());
+		return false;
+	}
+	return true;
+}
+
+bool isGraphFile(const char *filename)
+{
+	FILE *file = fopen(filename, "rb");
+	if (file == nullptr)
+		return false;
+	char magic[4];
+	bool match = fread(magic, 1, 4, file) == 4 && memcmp(magic, GRAPH_FILE_MAGIC, 4) == 0;
+	fclose(file);
+	return match;
+}
+
+CSRGraph *loadGraphFile(const char *filename)
+{
+	MappedFile *mapping = new MappedFile();
+	if (!mapping->map(filename) || mapping->size() < sizeof(GraphFileHeader))
+	{
+		delete mapping;
+		return nullptr;
+	}
+
+	GraphFileHeader header;
+	memcpy(&header, mapping->data(), sizeof(header));
+	bool reverse = (header.flags & GRAPH_FILE_REVERSE) != 0;
+	long long vertices = header.vertices;
+	long long edges = header.edges;
+	long long ints = (vertices + 1 + 2 * edges) * (reverse ? 2 : 1);
+	bool valid = memcmp(header.magic, GRAPH_FILE_MAGIC, 4) == 0 &&
+				 header.byteOrder == GRAPH_FILE_BYTE_ORDER &&
+				 header.version == GRAPH_FILE_VERSION &&
+				 (header.format == 'L' || header.format == 'M') &&
+				 vertices >= 0 && edges >= 0 &&
+				 mapping->size() == sizeof(header) + ints * sizeof(int);
+
+	// one pass over the indexes, every later lookup trusts them
+	int *outOffset = (int *)(mapping->data() + sizeof(header));
+	int *outTarget = outOffset + vertices + 1;
+	int *outWeight = outTarget + edges;
+	int *inOffset = reverse ? outWeight + edges : nullptr;
+	int *inSource = reverse ? inOffset + vertices + 1 : nullptr;
+	int *inWeight = reverse ? inSource + edges : nullptr;
+	valid = valid && validIndex(outOffset, outTarget, vertices, edges);
+	valid = valid && (!reverse || validIndex(inOffset, inSource, vertices, edges));
+	if (!valid)
+	{
+		delete mapping;
+		return nullptr;
+	}
+
+	CSRGraph *graph = new CSRGraph(false, header.vertices, (char)header.format);
+	graph->attach(mapping, header.edges, outOffset, outTarget, outWeight, inOffset, inSource, inWeight);
+	return graph;
+}
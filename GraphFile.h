@@ -0,0 +1,59 @@
+#ifndef _GRAPHFILE_H_
+#define _GRAPHFILE_H_
+
+#include "Graph.h"
+#include <cstdio>
+#include <stdint.h>
+
+class CSRGraph;
+
+// Binary CSR graph files written by SAVE and mapped by LOAD
+// a GraphFileHeader, then int32 arrays back to back in host byte order so they are used in place
+//   outOffset[vertices + 1], outTarget[edges], outWeight[edges]  : out-edges sorted by target
+//   inOffset[vertices + 1], inSource[edges], inWeight[edges]     : if GRAPH_FILE_REVERSE is set
+const char GRAPH_FILE_MAGIC[4] = {'D', 'S', 'G', 'B'};
+const uint32_t GRAPH_FILE_VERSION = 1;
+const uint32_t GRAPH_FILE_BYTE_ORDER = 0x01020304; // read back in another order on a foreign host
+
+// GraphFileHeader::flags
+const uint32_t GRAPH_FILE_REVERSE = 1; // in-edge index follows the out-edge index
+
+// 32 bytes
+struct GraphFileHeader
+{
+	char magic[4];
+	uint32_t byteOrder;
+	uint32_t version;
+	uint32_t flags;
+	int32_t format; // 'L' or 'M', the text format PRINT follows
+	int32_t vertices;
+	int32_t edges;
+	int32_t reserved;
+};
+
+// Private writable mapping of a whole file, pages are copied only when written
+class MappedFile
+{
+private:
+	void *m_Data;
+	size_t m_Size;
+
+public:
+	MappedFile();
+	~MappedFile();
+
+	bool map(const char *filename);
+	void unmap();
+
+	char *data() { return (char *)m_Data; }
+	size_t size() { return m_Size; }
+};
+
+// writes graph to filename ('L' or 'M' format), reverse adds the in-edge index
+bool saveGraphFile(Graph *graph, char format, const char *filename, bool reverse);
+// true if filename starts with the graph file magic
+bool isGraphFile(const char *filename);
+// maps a graph file, nullptr if it is not a valid one
+CSRGraph *loadGraphFile(const char *filename);
+
+#endif
@@ -1,6 +1,15 @@
 #include <iostream>
 #include <vector>
 #include "GraphMethod.h"
+#include "APSP.h"
+#include "SSSP.h"
+#include "ParallelBFS.h"
+#include "Parallel.h"
+#include "MST.h"
+#include "Betweenness.h"
+#include "Components.h"
+#include "TextFormat.h"
+#include "ResultExport.h"
 #include <stack>
 #include <queue>
 #include <map>
@@ -8,60 +17,21 @@
 #include <list>
 #include <utility> // for pair, make_pair
 #include <algorithm>
-#include <fstream>
 #include <climits>
 #include <iomanip>
 #include <cmath>
+#include <random>
 
 using namespace std;
 
-// Used to Initialize Shortest Path Algorithm
-const int INF = 100000000;
-
-// edge struct
-struct Edge
-{
-    int u, v, weight;
-    // Weighted ascending order
-    bool operator<(const Edge &other) const
-    {
-        if (weight != other.weight)
-            return weight < other.weight;
-        if (u != other.u)
-            return u < other.u;
-        return v < other.v;
-    }
-};
-
-// Union-Find Data Structure for Cycle Discrimination in Kruskal Algorithm
-struct DisjointSet
+// BIN flag : one summary line in log.txt in place of the text result
+static void printBinary(LogSink &fout, ResultWriter &file)
 {
-    vector<int> parent; // parent node
-
-    DisjointSet(int n)
-    {
-        parent.resize(n);
-        for (int i = 0; i < n; i++)
-            parent[i] = i;
-    }
-
-    int find(int u) // Return top root node using Path Compression
-    {
-        if (u == parent[u])
-            return u;
-        return parent[u] = find(parent[u]);
-    }
+    fout << "Binary: " << file.getName() << " (" << file.getBytes() << " bytes)" << endl;
+}
 
-    void merge(int u, int v) // Combine two sets into one
-    {
-        u = find(u);
-        v = find(v);
-        if (u != v)
-            parent[v] = u;
-    }
-};
 // Use a queue to visit from the nearest vertex to the starting vertex in turn
-bool BFS(Graph *graph, char option, int vertex)
+bool BFS(LogSink &fout, Graph *graph, char option, int vertex)
 {
     if (graph == NULL)
         return false;
@@ -70,12 +40,10 @@ bool BFS(Graph *graph, char option, int vertex)
     if (vertex < 0 || vertex >= size)
         return false;
 
-    ofstream fout("log.txt", ios::app);
-    vector<bool> visited(size, false);
-    queue<int> q;
-
-    q.push(vertex);
-    visited[vertex] = true;
+    // hop levels first (direction-optimizing, parallel), then the queue order rebuilt from them
+    vector<int> level, order;
+    bfsLevels(graph, option, vertex, level);
+    bfsOrder(graph, option, vertex, level, order);
 
     // output format
     fout << "========BFS========" << endl;
@@ -86,40 +54,53 @@ bool BFS(Graph *graph, char option, int vertex)
 
     fout << "Start: " << vertex << endl;
     fout << vertex;
-
-    // Until queue is empty
-    while (!q.empty())
+    for (size_t i = 1; i < order.size(); i++)
+        fout << " -> " << order[i];
+    fout << "\n=====================\n\n";
+    return true;
+}
+// BFS from every listed source, traversed together in batches of MSBFS_BATCH
+bool MSBFS(LogSink &fout, Graph *graph, char option, const vector<int> &sources)
+{
+    if (graph == NULL || sources.empty())
+        return false;
+    int size = graph->getSize();
+    for (size_t i = 0; i < sources.size(); i++)
     {
-        int curr = q.front();
-        q.pop();
+        if (sources[i] < 0 || sources[i] >= size)
+            return false;
+    }
 
-        multimap<int, int> adj;
-        // Import directional/non-directional neighbor vertices according to options
-        if (option == 'O')
-            graph->getAdjacentEdgesDirect(curr, &adj);
-        else
-            graph->getAdjacentEdges(curr, &adj);
+    fout << "========MSBFS========" << endl;
+    if (option == 'O')
+        fout << "Directed Graph MSBFS" << endl;
+    else
+        fout << "Undirected Graph MSBFS" << endl;
 
-        // Adjacent vertex traversal
-        multimap<int, int>::iterator it;
-        for (it = adj.begin(); it != adj.end(); it++)
+    vector<vector<int>> level;
+    vector<int> order;
+    for (size_t begin = 0; begin < sources.size(); begin += MSBFS_BATCH)
+    {
+        size_t end = min(sources.size(), begin + MSBFS_BATCH);
+        vector<int> batch(sources.begin() + begin, sources.begin() + end);
+        multiSourceBFS(graph, option, batch, level);
+
+        // same lines as BFS for each source
+        for (size_t i = 0; i < batch.size(); i++)
         {
-            int next = it->first;
-            // if not visited, add it to the queue and process the visit
-            if (visited[next] == false)
-            {
-                visited[next] = true;
-                q.push(next);
-                fout << " -> " << next;
-            }
+            bfsOrder(graph, option, batch[i], level[i], order);
+            fout << "Start: " << batch[i] << endl;
+            fout << batch[i];
+            for (size_t j = 1; j < order.size(); j++)
+                fout << " -> " << order[j];
+            fout << endl;
         }
     }
-    fout << "\n=====================\n\n";
-    fout.close();
+    fout << "=====================\n\n";
     return true;
 }
 // Use Stack to explore depth first
-bool DFS(Graph *graph, char option, int vertex)
+bool DFS(LogSink &fout, Graph *graph, char option, int vertex)
 {
     if (graph == NULL)
         return false;
@@ -127,9 +108,9 @@ bool DFS(Graph *graph, char option, int vertex)
     if (vertex < 0 || vertex >= size)
         return false;
 
-    ofstream fout("log.txt", ios::app);
     vector<bool> visited(size, false);
-    stack<int> s; // Stack for navigation
+    stack<int> s;    // Stack for navigation
+    vector<int> adj; // neighbor buffer, reused for every vertex
 
     s.push(vertex);
 
@@ -161,17 +142,16 @@ bool DFS(Graph *graph, char option, int vertex)
             fout << " -> " << curr;
         }
 
-        multimap<int, int> adj;
-        if (option == 'O')
-            graph->getAdjacentEdgesDirect(curr, &adj);
-        else
-            graph->getAdjacentEdges(curr, &adj);
+        adj.clear();
+        graph->forEachNeighbor(curr, option, [&](int next, int)
+        {
+            adj.push_back(next);
+        });
 
         // put it in reverse order so that the smaller number comes out
-        multimap<int, int>::reverse_iterator rit;
-        for (rit = adj.rbegin(); rit != adj.rend(); rit++)
+        for (int k = (int)adj.size() - 1; k >= 0; k--)
         {
-            int next = rit->first;
+            int next = adj[k];
             if (visited[next] == false)
             {
                 s.push(next);
@@ -179,71 +159,25 @@ bool DFS(Graph *graph, char option, int vertex)
         }
     }
     fout << "\n=====================\n\n";
-    fout.close();
     return true;
 }
 // an edge-centered grid algorithm, KRUSKAL
-bool Kruskal(Graph *graph)
+bool Kruskal(LogSink &fout, Graph *graph, ComponentIndex *components)
 {
     if (graph == NULL)
         return false;
+    // no spanning tree across several components
+    if (components != NULL && components->getWeakCount() > 1)
+        return false;
 
     int size = graph->getSize();
-    vector<Edge> edges;
-
-    for (int i = 0; i < size; i++)
-    {
-        multimap<int, int> adj;
-        graph->getAdjacentEdges(i, &adj);
-        // Collect all edges of the graph
-        multimap<int, int>::iterator it;
-        for (it = adj.begin(); it != adj.end(); it++)
-        {
-            int v = it->first;
-            int w = it->second;
-            // Avoid redundant edges
-            if (i < v)
-            {
-                Edge newEdge;
-                newEdge.u = i;
-                newEdge.v = v;
-                newEdge.weight = w;
-                edges.push_back(newEdge);
-            }
-        }
-    }
-
-    // Sort edge ascending order by weight
-    sort(edges.begin(), edges.end());
-
-    DisjointSet ds(size);
     vector<Edge> mstEdges;
     int mstCost = 0;
 
-    for (size_t i = 0; i < edges.size(); i++)
-    {
-        Edge curEdge = edges[i];
-        // If two vertices belong to different sets
-        if (ds.find(curEdge.u) != ds.find(curEdge.v))
-        {
-            ds.merge(curEdge.u, curEdge.v); // merge
-            mstEdges.push_back(curEdge);    // push MST
-            mstCost += curEdge.weight;      // add edge summation
-        }
-    }
-
-    // Check connectivity
-    int rootCount = 0;
-    for (int i = 0; i < size; i++)
-    {
-        if (ds.parent[i] == i)
-            rootCount++;
-    }
-
-    if (rootCount > 1)
+    // Filter-Kruskal or parallel Boruvka by edge count (MST.cpp), fails if disconnected
+    if (!minimumSpanningTree(graph, mstEdges, mstCost))
         return false;
 
-    ofstream fout("log.txt", ios::app);
     fout << "========KRUSKAL========" << endl;
 
     // Converting to adjacency list form for output
@@ -271,89 +205,17 @@ bool Kruskal(Graph *graph)
     }
     fout << "Cost: " << mstCost << endl;
     fout << "=======================\n\n";
-    fout.close();
 
     return true;
 }
 
-// Dijkstra, Use priority queue
-bool Dijkstra(Graph *graph, char option, int vertex)
+// "[v] s -> ... -> v (dist)" per vertex, x if unreachable
+static void printPaths(LogSink &fout, int size, const int *distRow, const int *parentRow)
 {
-    if (graph == NULL)
-        return false;
-    int size = graph->getSize();
-    if (vertex < 0 || vertex >= size)
-        return false;
-
-    // negative weight check
-    for (int i = 0; i < size; i++)
-    {
-        multimap<int, int> adj;
-        if (option == 'O')
-            graph->getAdjacentEdgesDirect(i, &adj);
-        else
-            graph->getAdjacentEdges(i, &adj);
-
-        multimap<int, int>::iterator it;
-        for (it = adj.begin(); it != adj.end(); it++)
-        {
-            if (it->second < 0)
-                return false; // Error when finding negative weights
-        }
-    }
-
-    vector<int> dist(size, INF);
-    vector<int> parent(size, -1);
-
-    // min-heap
-    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
-
-    dist[vertex] = 0;
-    pq.push(make_pair(0, vertex));
-
-    while (!pq.empty())
-    {
-        int cost = pq.top().first;
-        int curr = pq.top().second;
-        pq.pop();
-        // Skip if you already visited on a shorter route
-        if (dist[curr] < cost)
-            continue;
-
-        multimap<int, int> adj;
-        if (option == 'O')
-            graph->getAdjacentEdgesDirect(curr, &adj);
-        else
-            graph->getAdjacentEdges(curr, &adj);
-
-        multimap<int, int>::iterator it;
-        for (it = adj.begin(); it != adj.end(); it++)
-        {
-            int next = it->first;
-            int weight = it->second;
-            // Renew if the distance is shorter
-            if (dist[next] > cost + weight)
-            {
-                dist[next] = cost + weight;
-                parent[next] = curr;
-                pq.push(make_pair(dist[next], next));
-            }
-        }
-    }
-
-    ofstream fout("log.txt", ios::app);
-    fout << "========DIJKSTRA========" << endl;
-    if (option == 'O')
-        fout << "Directed Graph Dijkstra" << endl;
-    else
-        fout << "Undirected Graph Dijkstra" << endl;
-
-    fout << "Start: " << vertex << endl;
-
     for (int i = 0; i < size; i++)
     {
         fout << "[" << i << "] ";
-        if (dist[i] == INF) // if Unreachable
+        if (distRow[i] == INF) // if Unreachable
         {
             fout << "x" << endl;
         }
@@ -364,7 +226,7 @@ bool Dijkstra(Graph *graph, char option, int vertex)
             while (curr != -1)
             {
                 path.push_back(curr);
-                curr = parent[curr];
+                curr = parentRow[curr];
             }
             // Route Reverse Output
             for (int k = (int)path.size() - 1; k >= 0; k--)
@@ -373,89 +235,148 @@ bool Dijkstra(Graph *graph, char option, int vertex)
                 if (k > 0)
                     fout << " -> ";
             }
-            fout << " (" << dist[i] << ")" << endl;
+            fout << " (" << distRow[i] << ")" << endl;
         }
     }
-    fout << "========================\n\n";
-    fout.close();
-
-    return true;
 }
-// Bellmanford
-bool Bellmanford(Graph *graph, char option, int s_vertex, int e_vertex)
+
+// Dijkstra, sequential (queue chosen by weight range) or delta-stepping (SSSP.cpp)
+bool Dijkstra(LogSink &fout, Graph *graph, char option, int vertex, SSSPMode mode, APSPCache *cache, SSSPCache *trees, bool binary)
 {
     if (graph == NULL)
         return false;
     int size = graph->getSize();
-    if (s_vertex < 0 || s_vertex >= size || e_vertex < 0 || e_vertex >= size)
+    if (vertex < 0 || vertex >= size)
         return false;
 
-    vector<int> dist(size, INF);
-    vector<int> parent(size, -1);
-    dist[s_vertex] = 0;
+    vector<int> dist;
+    vector<int> parent;
+    const int *distRow, *parentRow;
+    // explicit SEQ / DELTA always run the algorithm
+    APSPEntry *entry = cache != NULL && mode == SSSP_AUTO ? cache->find(option) : NULL;
+    const SSSPTree *tree = NULL;
+    if (entry != NULL && entry->hasParent)
+    {
+        // all-pairs result already cached, the tree is one row lookup
+        distRow = entry->dist.row(vertex);
+        parentRow = &entry->parent[(size_t)vertex * size];
+    }
+    else if (trees != NULL && mode == SSSP_AUTO && (tree = trees->find(vertex, option, FAMILY_DIJKSTRA)) != NULL)
+    {
+        // same source seen before, weights were checked then
+        distRow = &tree->dist[0];
+        parentRow = &tree->parent[0];
+    }
+    else
+    {
+        // negative weight check
+        WeightRange range = scanWeights(graph, option);
+        if (range.hasEdge && range.minWeight < 0)
+            return false; // Error when finding negative weights
+
+        shortestPathTree(graph, option, vertex, range, mode, dist, parent);
+        distRow = &dist[0];
+        parentRow = &parent[0];
+    }
 
-    // Number of vertices - 1 Repeat to update shortest distance
-    for (int i = 0; i < size - 1; i++)
+    ResultWriter file;
+    if (binary)
     {
-        for (int u = 0; u < size; u++)
-        {
-            if (dist[u] == INF)
-                continue;
+        // one distance row and its parent row
+        uint32_t flags = (option == 'O' ? RESULT_DIRECTED : 0) | RESULT_PARENTS;
+        if (!file.open(resultFileName("dijkstra", option, vertex), RESULT_DISTANCES, flags, size, 1, vertex))
+            return false;
+        file.writeInts(distRow, size);
+        file.writeInts(parentRow, size);
+        if (!file.close())
+            return false;
+    }
 
-            multimap<int, int> adj;
-            if (option == 'O')
-                graph->getAdjacentEdgesDirect(u, &adj);
-            else
-                graph->getAdjacentEdges(u, &adj);
+    fout << "========DIJKSTRA========" << endl;
+    if (option == 'O')
+        fout << "Directed Graph Dijkstra" << endl;
+    else
+        fout << "Undirected Graph Dijkstra" << endl;
 
-            multimap<int, int>::iterator it;
-            for (it = adj.begin(); it != adj.end(); it++)
-            {
-                int v = it->first;
-                int w = it->second;
+    fout << "Start: " << vertex << endl;
 
-                if (dist[v] > dist[u] + w)
-                {
-                    dist[v] = dist[u] + w;
-                    parent[v] = u;
-                }
-            }
-        }
-    }
+    if (binary)
+        printBinary(fout, file);
+    else
+        printPaths(fout, size, distRow, parentRow);
+    fout << "========================\n\n";
 
-    // Check negative cycle
-    for (int u = 0; u < size; u++)
-    {
-        if (dist[u] == INF)
-            continue;
+    // keep the fresh tree for the next query from this source
+    if (trees != NULL && !dist.empty())
+        trees->insert(vertex, option, FAMILY_DIJKSTRA, true, dist, parent);
 
-        multimap<int, int> adj;
-        if (option == 'O')
-            graph->getAdjacentEdgesDirect(u, &adj);
-        else
-            graph->getAdjacentEdges(u, &adj);
+    return true;
+}
+// Bellmanford
+bool Bellmanford(LogSink &fout, Graph *graph, char option, int s_vertex, int e_vertex, APSPCache *cache, SSSPCache *trees, ComponentIndex *components)
+{
+    if (graph == NULL)
+        return false;
+    int size = graph->getSize();
+    if (s_vertex < 0 || s_vertex >= size || e_vertex < 0 || e_vertex >= size)
+        return false;
 
-        multimap<int, int>::iterator it;
-        for (it = adj.begin(); it != adj.end(); it++)
+    vector<int> dist;
+    vector<int> parent;
+    vector<int> unreached; // dist row of a target known to be unreachable
+    const int *distRow, *parentRow;
+    APSPEntry *entry = cache != NULL ? cache->find(option) : NULL;
+    const SSSPTree *tree = NULL;
+    if (components != NULL && option != 'O' && components->hasNegative(s_vertex))
+        return false; // an undirected negative edge is a negative cycle
+    if (components != NULL && components->negativeCycleFree(option, s_vertex) && components->unreachable(option, s_vertex, e_vertex))
+    {
+        // no search needed to print x
+        unreached.assign(size, INF);
+        distRow = parentRow = &unreached[0];
+    }
+    else if (entry != NULL && entry->hasParent)
+    {
+        // all-pairs result already cached
+        distRow = entry->dist.row(s_vertex);
+        parentRow = &entry->parent[(size_t)s_vertex * size];
+    }
+    else if (trees != NULL && (tree = trees->find(s_vertex, option, FAMILY_BELLMANFORD)) != NULL)
+    {
+        // tree of an earlier query from the same source
+        if (!tree->valid)
+            return false;
+        distRow = &tree->dist[0];
+        parentRow = &tree->parent[0];
+    }
+    else
+    {
+        // SPFA worklist, fails if a negative cycle is reachable
+        if (!bellmanFordTree(graph, option, s_vertex, dist, parent))
         {
-            int v = it->first;
-            int w = it->second;
-
-            if (dist[v] > dist[u] + w)
+            // remember the failure as well
+            if (trees != NULL)
             {
-                return false; // Negative cycle still present if updated
+                vector<int> none;
+                trees->insert(s_vertex, option, FAMILY_BELLMANFORD, false, none, none);
             }
+            return false;
         }
+        // positive weights : same path as Dijkstra and the cached lookup
+        WeightRange range = scanWeights(graph, option);
+        if (!range.hasEdge || range.minWeight > 0)
+            tightParents(graph, option, s_vertex, &dist[0], &parent[0]);
+        distRow = &dist[0];
+        parentRow = &parent[0];
     }
 
-    ofstream fout("log.txt", ios::app);
     fout << "========BELLMANFORD========" << endl;
     if (option == 'O')
         fout << "Directed Graph Bellman-Ford" << endl;
     else
         fout << "Undirected Graph Bellman-Ford" << endl;
 
-    if (dist[e_vertex] == INF)
+    if (distRow[e_vertex] == INF)
     {
         fout << "x" << endl;
     }
@@ -466,7 +387,7 @@ bool Bellmanford(Graph *graph, char option, int s_vertex, int e_vertex)
         while (curr != -1)
         {
             path.push_back(curr);
-            curr = parent[curr];
+            curr = parentRow[curr];
         }
 
         for (int k = (int)path.size() - 1; k >= 0; k--)
@@ -475,147 +396,269 @@ bool Bellmanford(Graph *graph, char option, int s_vertex, int e_vertex)
             if (k > 0)
                 fout << " -> ";
         }
-        fout << "\nCost: " << dist[e_vertex] << endl;
+        fout << "\nCost: " << distRow[e_vertex] << endl;
     }
     fout << "===========================\n\n";
-    fout.close();
+
+    if (trees != NULL && !dist.empty())
+        trees->insert(s_vertex, option, FAMILY_BELLMANFORD, true, dist, parent);
 
     return true;
 }
-// Floyd
-bool FLOYD(Graph *graph, char option)
+// Point to point query, bidirectional Dijkstra or Bellman-Ford fallback
+bool ShortestPath(LogSink &fout, PointToPoint *search, char option, int s_vertex, int e_vertex)
 {
-    if (graph == NULL)
+    if (search == NULL)
+        return false;
+    int size = search->getSize();
+    if (s_vertex < 0 || s_vertex >= size || e_vertex < 0 || e_vertex >= size)
         return false;
-    int size = graph->getSize();
 
-    // Initialize 2D Array
-    vector<vector<int>> dist(size, vector<int>(size, INF));
+    int cost;
+    vector<int> path;
+    bool bidirectional;
+    if (!search->query(option, s_vertex, e_vertex, cost, path, bidirectional))
+        return false; // negative cycle
 
-    for (int i = 0; i < size; i++)
-        dist[i][i] = 0; // The diagonal part is zero
+    fout << "========SHORTESTPATH========" << endl;
+    if (option == 'O')
+        fout << "Directed Graph ";
+    else
+        fout << "Undirected Graph ";
+    if (bidirectional)
+        fout << "Bidirectional Dijkstra" << endl;
+    else
+        fout << "Bellman-Ford" << endl;
 
-    // Enter initial edge information
-    for (int i = 0; i < size; i++)
+    if (cost == INF)
     {
-        multimap<int, int> adj;
-        if (option == 'O')
-            graph->getAdjacentEdgesDirect(i, &adj);
-        else
-            graph->getAdjacentEdges(i, &adj);
-
-        multimap<int, int>::iterator it;
-        for (it = adj.begin(); it != adj.end(); it++)
+        fout << "x" << endl;
+    }
+    else
+    {
+        for (size_t k = 0; k < path.size(); k++)
         {
-            int v = it->first;
-            int w = it->second;
-            // Select the smallest weight
-            if (dist[i][v] > w)
-                dist[i][v] = w;
+            fout << path[k];
+            if (k + 1 < path.size())
+                fout << " -> ";
         }
+        fout << "\nCost: " << cost << endl;
     }
+    fout << "============================\n\n";
 
-    // Shortest distance update via triple iteration
-    for (int k = 0; k < size; k++)
+    return true;
+}
+// Contraction hierarchy preprocessing report
+bool CHBuild(LogSink &fout, ContractionHierarchy *ch)
+{
+    if (ch == NULL)
+        return false;
+
+    fout << "========CHBUILD========" << endl;
+    if (ch->getOption() == 'O')
+        fout << "Directed Graph Contraction Hierarchy" << endl;
+    else
+        fout << "Undirected Graph Contraction Hierarchy" << endl;
+    fout << "Shortcuts: " << ch->getShortcutCount() << endl;
+    fout << "Time: " << fixed << setprecision(3) << ch->getBuildTime() << " ms" << endl;
+    fout << "=======================\n\n";
+
+    return true;
+}
+// s -> t query answered by the contraction hierarchy
+bool CHQuery(LogSink &fout, ContractionHierarchy *ch, int s_vertex, int e_vertex, ComponentIndex *components)
+{
+    if (ch == NULL)
+        return false;
+    int size = ch->getSize();
+    if (s_vertex < 0 || s_vertex >= size || e_vertex < 0 || e_vertex >= size)
+        return false;
+
+    int cost = INF;
+    vector<int> path;
+    // different components need no search
+    if (components == NULL || !components->unreachable(ch->getOption(), s_vertex, e_vertex))
+        ch->query(s_vertex, e_vertex, cost, path);
+
+    fout << "========CHQUERY========" << endl;
+    if (ch->getOption() == 'O')
+        fout << "Directed Graph Contraction Hierarchy" << endl;
+    else
+        fout << "Undirected Graph Contraction Hierarchy" << endl;
+
+    if (cost == INF)
     {
-        for (int i = 0; i < size; i++)
+        fout << "x" << endl;
+    }
+    else
+    {
+        for (size_t k = 0; k < path.size(); k++)
         {
-            for (int j = 0; j < size; j++)
-            {
-                if (dist[i][k] != INF && dist[k][j] != INF)
-                {
-                    if (dist[i][j] > dist[i][k] + dist[k][j])
-                    {
-                        dist[i][j] = dist[i][k] + dist[k][j];
-                    }
-                }
-            }
+            fout << path[k];
+            if (k + 1 < path.size())
+                fout << " -> ";
         }
+        fout << "\nCost: " << cost << endl;
     }
+    fout << "=======================\n\n";
 
-    // Check negative cycle
-    for (int i = 0; i < size; i++)
+    return true;
+}
+// Shortest path tree cache statistics
+bool CacheStats(LogSink &fout, SSSPCache *trees)
+{
+    if (trees == NULL)
+        return false;
+
+    fout << "========CACHE========" << endl;
+    fout << "Trees: " << trees->getTreeCount() << endl;
+    fout << "Memory: " << trees->getBytes() << " / " << trees->getBudget() << " bytes" << endl;
+    fout << "Hits: " << trees->getHits() << endl;
+    fout << "Misses: " << trees->getMisses() << endl;
+    fout << "Evictions: " << trees->getEvictions() << endl;
+    fout << "=====================\n\n";
+
+    return true;
+}
+// Floyd
+bool FLOYD(LogSink &fout, Graph *graph, char option, APSPCache *cache, bool binary)
+{
+    if (graph == NULL)
+        return false;
+    int size = graph->getSize();
+
+    // Floyd-Warshall or Johnson by density (cached when possible), fails on a negative cycle
+    DistanceMatrix local;
+    DistanceMatrix *dist = &local;
+    APSPEntry *entry = NULL;
+    if (cache != NULL)
     {
-        if (dist[i][i] < 0)
+        entry = cache->get(graph, option);
+        if (!entry->valid)
+            return false;
+        dist = &entry->dist;
+    }
+    else if (!allPairsShortestPaths(graph, option, local))
+        return false;
+
+    ResultWriter file;
+    if (binary)
+    {
+        // rows without their padding, then the parent matrix if the cache built one
+        bool parents = entry != NULL && entry->hasParent;
+        uint32_t flags = (option == 'O' ? RESULT_DIRECTED : 0) | (parents ? RESULT_PARENTS : 0);
+        if (!file.open(resultFileName("floyd", option, -1), RESULT_DISTANCES, flags, size, size, -1))
+            return false;
+        for (int i = 0; i < size; i++)
+            file.writeInts(dist->row(i), size);
+        if (parents)
+            file.writeInts(&entry->parent[0], (size_t)size * size);
+        if (!file.close())
             return false;
     }
 
-    ofstream fout("log.txt", ios::app);
     fout << "========FLOYD========" << endl;
     if (option == 'O')
         fout << "Directed Graph Floyd" << endl;
     else
         fout << "Undirected Graph Floyd" << endl;
 
-    fout << "\t";
-    for (int i = 0; i < size; i++)
-        fout << "[" << i << "]" << "\t";
-    fout << endl;
-
-    for (int i = 0; i < size; i++)
+    if (binary)
     {
-        fout << "[" << i << "]" << "\t";
-        for (int j = 0; j < size; j++)
-        {
-            if (dist[i][j] == INF)
-                fout << "x" << "\t";
-            else
-                fout << dist[i][j] << "\t";
-        }
-        fout << endl;
+        printBinary(fout, file);
+        fout << "=====================\n\n";
+        return true;
     }
+
+    // header, then the rows formatted in parallel blocks (INF as x)
+    TextBuffer header;
+    formatMatrixHeader(header, size);
+    fout.write(header.data(), header.size());
+    writeRows(fout, size, [&](int i, TextBuffer &text)
+    {
+        formatMatrixRow(text, i, dist->row(i), size);
+    });
     fout << "=====================\n\n";
-    fout.close();
 
     return true;
 }
 // Centrality
-bool Centrality(Graph *graph)
+bool Centrality(LogSink &fout, Graph *graph, APSPCache *cache, ComponentIndex *components, bool binary)
 {
     if (graph == NULL)
         return false;
     int size = graph->getSize();
 
-    // Floyd logic reuse
-    vector<vector<int>> dist(size, vector<int>(size, INF));
-    for (int i = 0; i < size; i++)
-        dist[i][i] = 0;
+    // distance sum of every vertex, Centrality is based on a undirected graph
+    vector<int> sumPath(size, 0);
+    vector<char> disconnected(size, false);
+    WeightRange range = scanWeights(graph, 'X');
+    if (range.hasEdge && range.minWeight < 0)
+        return false; // a negative undirected edge is a negative cycle
 
-    for (int i = 0; i < size; i++)
+    APSPEntry *entry = cache != NULL ? cache->find('X') : NULL;
+    if (components != NULL && components->getWeakCount() > 1)
     {
-        multimap<int, int> adj;
-        graph->getAdjacentEdges(i, &adj); // Centrality is based on a undirected graph
-
-        multimap<int, int>::iterator it;
-        for (it = adj.begin(); it != adj.end(); it++)
-        {
-            int v = it->first;
-            int w = it->second;
-            if (dist[i][v] > w)
-                dist[i][v] = w;
-        }
+        // several components : every vertex misses some other vertex
+        disconnected.assign(size, true);
     }
-
-    for (int k = 0; k < size; k++)
+    else if (entry != NULL)
     {
+        // FLOYD X already ran, sum the cached rows
+        if (!entry->valid)
+            return false;
         for (int i = 0; i < size; i++)
         {
+            const int *row = entry->dist.row(i);
             for (int j = 0; j < size; j++)
             {
-                if (dist[i][k] != INF && dist[k][j] != INF)
+                if (row[j] == INF)
+                    disconnected[i] = true;
+                else
+                    sumPath[i] += row[j];
+            }
+        }
+    }
+    else if (range.hasEdge && range.minWeight == range.maxWeight)
+    {
+        // every edge costs the same : distance = hops * weight, multi-source BFS
+        vector<vector<int>> level;
+        vector<int> batch;
+        for (int begin = 0; begin < size; begin += MSBFS_BATCH)
+        {
+            batch.clear();
+            for (int i = begin; i < size && i < begin + MSBFS_BATCH; i++)
+                batch.push_back(i);
+            multiSourceBFS(graph, 'X', batch, level);
+            parallelFor(0, (int)batch.size(), [&](int i, int)
+            {
+                for (int j = 0; j < size; j++)
                 {
-                    if (dist[i][j] > dist[i][k] + dist[k][j])
-                    {
-                        dist[i][j] = dist[i][k] + dist[k][j];
-                    }
+                    if (level[i][j] == -1)
+                        disconnected[begin + i] = true;
+                    else
+                        sumPath[begin + i] += level[i][j] * range.minWeight;
                 }
-            }
+            });
         }
     }
-
-    for (int i = 0; i < size; i++)
-        if (dist[i][i] < 0)
-            return false;
+    else
+    {
+        // one Dijkstra per source in parallel, only the row sum is kept
+        vector<int> sources(size);
+        for (int i = 0; i < size; i++)
+            sources[i] = i;
+        forEachSourceTree(graph, 'X', sources, range, [&](int i, const vector<int> &dist, int)
+        {
+            for (int j = 0; j < size; j++)
+            {
+                if (dist[j] == INF)
+                    disconnected[i] = true;
+                else
+                    sumPath[i] += dist[j];
+            }
+        });
+    }
 
     // centrality calculation
     vector<pair<double, int>> closeness(size);
@@ -623,29 +666,15 @@ bool Centrality(Graph *graph)
 
     for (int i = 0; i < size; i++)
     {
-        int sumPath = 0;
-        bool disconnected = false;
-
-        for (int j = 0; j < size; j++)
-        {
-            if (i == j)
-                continue;
-            if (dist[i][j] == INF)
-            {
-                disconnected = true;
-                break;
-            }
-            sumPath += dist[i][j];
-        }
         // Process if there are unconnected vertices or if the path sum is zero
-        if (disconnected || sumPath == 0)
+        if (disconnected[i] || sumPath[i] == 0)
         {
             closeness[i] = make_pair(0.0, i);
         }
         else
         {
             //(N-1) / (Total distance to all vertices)
-            double val = (double)(size - 1) / sumPath;
+            double val = (double)(size - 1) / sumPath[i];
             closeness[i] = make_pair(val, i);
         }
 
@@ -653,36 +682,201 @@ bool Centrality(Graph *graph)
             maxVal = closeness[i].first;
     }
 
-    ofstream fout("log.txt", ios::app);
+    if (binary)
+    {
+        // total distance per vertex, -1 where the text shows x
+        vector<double> total(size);
+        for (int i = 0; i < size; i++)
+            total[i] = closeness[i].first == 0.0 ? -1.0 : sumPath[i];
+        ResultWriter file;
+        if (!file.open(resultFileName("centrality", '\0', -1), RESULT_CLOSENESS, 0, size, 1, -1))
+            return false;
+        file.writeDoubles(&total[0], size);
+        if (!file.close())
+            return false;
+
+        fout << "========CENTRALITY========" << endl;
+        printBinary(fout, file);
+        fout << "==========================\n\n";
+        return true;
+    }
+
     fout << "========CENTRALITY========" << endl;
 
-    for (int i = 0; i < size; i++)
+    writeRows(fout, size, [&](int i, TextBuffer &text)
     {
-        fout << "[" << i << "] ";
+        text.putLabel(i);
+        text.put(' ');
         if (closeness[i].first == 0.0)
         {
-            fout << "x" << endl;
+            text.put("x\n");
+            return;
         }
-        else
+        text.putInt(size - 1);
+        text.put('/');
+        text.putInt(sumPath[i]);
+        if (abs(closeness[i].first - maxVal) < 1e-9)
+            text.put(" <- Most Central");
+        text.put('\n');
+    });
+
+    fout << "==========================\n\n";
+    return true;
+}
+// Closeness estimated from random pivots (Eppstein-Wang), undirected
+bool ApproxCentrality(LogSink &fout, Graph *graph, int pivots, ComponentIndex *components, bool binary)
+{
+    if (graph == NULL || pivots < 1)
+        return false;
+    int size = graph->getSize();
+    WeightRange range = scanWeights(graph, 'X');
+    if (range.hasEdge && range.minWeight < 0)
+        return false; // a negative undirected edge is a negative cycle
+
+    // k distinct pivots, fixed seed so the output is reproducible
+    int k = min(pivots, size);
+    vector<int> sample(size);
+    for (int i = 0; i < size; i++)
+        sample[i] = i;
+    mt19937 rng(CENTRALITY_SEED);
+    for (int i = 0; i < k; i++)
+        swap(sample[i], sample[i + rng() % (size - i)]);
+    sample.resize(k);
+
+    // distance sums from the pivots, one accumulator per worker
+    int workers = workerCount();
+    vector<vector<long long>> partial(workers, vector<long long>(size, 0));
+    vector<int> eccentricity(k, 0);
+    vector<char> reachesAll(k, true);
+    // several components : every vertex gets x, no pivot needs to run
+    bool split = components != NULL && components->getWeakCount() > 1;
+    if (!split)
+    {
+        forEachSourceTree(graph, 'X', sample, range, [&](int i, const vector<int> &dist, int worker)
         {
-            int sumPath = 0;
-            for (int j = 0; j < size; j++)
+            for (int v = 0; v < size; v++)
             {
-                if (i != j)
-                    sumPath += dist[i][j];
+                if (dist[v] == INF)
+                    reachesAll[i] = false;
+                else
+                {
+                    partial[worker][v] += dist[v];
+                    eccentricity[i] = max(eccentricity[i], dist[v]);
+                }
             }
+        });
+    }
 
-            fout << (size - 1) << "/" << sumPath;
+    vector<long long> pivotSum(size, 0);
+    for (int w = 0; w < workers; w++)
+    {
+        for (int v = 0; v < size; v++)
+            pivotSum[v] += partial[w][v];
+    }
+    // one pivot missing a vertex means the graph is disconnected, every vertex gets x
+    bool connected = !split;
+    int diameter = INF; // 2 * eccentricity of any vertex bounds the diameter
+    for (int i = 0; i < k; i++)
+    {
+        connected = connected && reachesAll[i];
+        diameter = min(diameter, 2 * eccentricity[i]);
+    }
 
-            if (abs(closeness[i].first - maxVal) < 1e-9)
-            {
-                fout << " <- Most Central";
-            }
-            fout << endl;
-        }
+    // total distance of v ~ n / k * (distances from the pivots to v)
+    vector<double> estimate(size, 0.0);
+    double maxVal = -1.0;
+    for (int v = 0; v < size; v++)
+    {
+        estimate[v] = (double)size / k * pivotSum[v];
+        if (connected && estimate[v] > 0 && (size - 1) / estimate[v] > maxVal)
+            maxVal = (size - 1) / estimate[v];
+    }
+
+    ResultWriter file;
+    if (binary)
+    {
+        // estimated total distance per vertex, -1 where the text shows x
+        vector<double> total(size);
+        for (int v = 0; v < size; v++)
+            total[v] = !connected || estimate[v] == 0 ? -1.0 : estimate[v];
+        if (!file.open(resultFileName("centrality", '\0', -1), RESULT_CLOSENESS, RESULT_APPROX, size, 1, -1))
+            return false;
+        file.writeDoubles(&total[0], size);
+        if (!file.close())
+            return false;
     }
 
+    fout << "========CENTRALITY========" << endl;
+    fout << "Approximate: " << k << " pivots" << endl;
+    if (binary)
+    {
+        printBinary(fout, file);
+        fout << "==========================\n\n";
+        return true;
+    }
+    fout << fixed << setprecision(1);
+    for (int v = 0; v < size; v++)
+    {
+        fout << "[" << v << "] ";
+        if (!connected || estimate[v] == 0)
+        {
+            fout << "x" << endl;
+            continue;
+        }
+        fout << (size - 1) << "/" << estimate[v];
+        if (abs((size - 1) / estimate[v] - maxVal) < 1e-9)
+            fout << " <- Most Central";
+        fout << endl;
+    }
+    // Eppstein-Wang : the average distance is within diameter * sqrt(log n / k) with high probability
+    double error = k == size || !connected ? 0.0 : diameter * sqrt(log((double)size) / k);
+    fout << "Error: +-" << setprecision(3) << error << " (average distance)" << endl;
     fout << "==========================\n\n";
-    fout.close();
+    return true;
+}
+// Brandes betweenness, top vertices by score, optionally from sampled sources
+bool Betweenness(LogSink &fout, Graph *graph, char option, int top, int samples)
+{
+    if (graph == NULL)
+        return false;
+    int size = graph->getSize();
+    WeightRange range = scanWeights(graph, option);
+    if (range.hasEdge && range.minWeight < 0)
+        return false; // Dijkstra based, no negative weights
+
+    // every vertex, or the first samples of a seeded shuffle
+    vector<int> sources(size);
+    for (int i = 0; i < size; i++)
+        sources[i] = i;
+    bool sampled = samples > 0 && samples < size;
+    if (sampled)
+    {
+        mt19937 rng(CENTRALITY_SEED);
+        for (int i = 0; i < samples; i++)
+            swap(sources[i], sources[i + rng() % (size - i)]);
+        sources.resize(samples);
+    }
+
+    vector<double> score;
+    betweenness(graph, option, sources, score);
+
+    // highest score first, ties by vertex
+    vector<pair<double, int>> ranked(size);
+    for (int i = 0; i < size; i++)
+        ranked[i] = make_pair(-score[i], i);
+    int shown = top > 0 ? min(top, size) : min(BETWEENNESS_TOP, size);
+    partial_sort(ranked.begin(), ranked.begin() + shown, ranked.end());
+
+    fout << "========BETWEENNESS========" << endl;
+    if (option == 'O')
+        fout << "Directed Graph Betweenness" << endl;
+    else
+        fout << "Undirected Graph Betweenness" << endl;
+    if (sampled)
+        fout << "Sampled: " << samples << " sources" << endl;
+    fout << fixed << setprecision(2);
+    for (int i = 0; i < shown; i++)
+        fout << "[" << ranked[i].second << "] " << -ranked[i].first << endl;
+    fout << "===========================\n\n";
     return true;
 }
\ No newline at end of file
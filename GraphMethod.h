@@ -3,13 +3,31 @@
 
 #include "ListGraph.h"
 #include "MatrixGraph.h"
+#include "SSSP.h"
+#include "APSP.h"
+#include "PointToPoint.h"
+#include "ContractionHierarchy.h"
+#include "Components.h"
+#include "LogSink.h"
 
-bool BFS(Graph* graph, char option, int vertex);     
-bool DFS(Graph* graph, char option,  int vertex);     
-bool Centrality(Graph* graph);  
-bool Kruskal(Graph* graph);
-bool Dijkstra(Graph* graph, char option, int vertex);    //Dijkstra
-bool Bellmanford(Graph* graph, char option, int s_vertex, int e_vertex); //Bellman - Ford
-bool FLOYD(Graph* graph, char option);   //FLoyd
+// Seed of the CENTRALITY APPROX pivot and BETWEENNESS source sampling
+const unsigned CENTRALITY_SEED = 2022;
+
+// Every command writes its block to fout, the sink owned by Manager
+// binary (BIN flag) writes the result to a ResultExport file and only a summary line to fout
+bool BFS(LogSink& fout, Graph* graph, char option, int vertex);     
+bool MSBFS(LogSink& fout, Graph* graph, char option, const vector<int>& sources); //batched BFS
+bool DFS(LogSink& fout, Graph* graph, char option,  int vertex);     
+bool Centrality(LogSink& fout, Graph* graph, APSPCache* cache = NULL, ComponentIndex* components = NULL, bool binary = false);  
+bool ApproxCentrality(LogSink& fout, Graph* graph, int pivots, ComponentIndex* components = NULL, bool binary = false); //sampled closeness
+bool Betweenness(LogSink& fout, Graph* graph, char option, int top, int samples); //Brandes
+bool Kruskal(LogSink& fout, Graph* graph, ComponentIndex* components = NULL);
+bool Dijkstra(LogSink& fout, Graph* graph, char option, int vertex, SSSPMode mode = SSSP_AUTO, APSPCache* cache = NULL, SSSPCache* trees = NULL, bool binary = false);    //Dijkstra
+bool Bellmanford(LogSink& fout, Graph* graph, char option, int s_vertex, int e_vertex, APSPCache* cache = NULL, SSSPCache* trees = NULL, ComponentIndex* components = NULL); //Bellman - Ford
+bool FLOYD(LogSink& fout, Graph* graph, char option, APSPCache* cache = NULL, bool binary = false);   //FLoyd
+bool ShortestPath(LogSink& fout, PointToPoint* search, char option, int s_vertex, int e_vertex); //s -> t query
+bool CHBuild(LogSink& fout, ContractionHierarchy* ch);   //hierarchy statistics
+bool CHQuery(LogSink& fout, ContractionHierarchy* ch, int s_vertex, int e_vertex, ComponentIndex* components = NULL); //s -> t query on the hierarchy
+bool CacheStats(LogSink& fout, SSSPCache* trees); //tree cache counters
 
 #endif
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "ListGraph.h"
+#include "TextFormat.h"
 #include <iostream>
 #include <utility>
 
@@ -8,13 +9,14 @@ using namespace std;
 ListGraph::ListGraph(bool type, int size) : Graph(type, size)
 {
     m_List = new multimap<int, int>[size];
-    ;
+    m_InList = new multimap<int, int>[size];
 }
 
 // destructor
 ListGraph::~ListGraph()
 {
     delete[] m_List;
+    delete[] m_InList;
 }
 
 // undirected perspective
@@ -26,19 +28,13 @@ void ListGraph::getAdjacentEdges(int vertex, multimap<int, int> *m)
         m->insert(make_pair(item.first, item.second));
     }
 
-    // all in-degree edges
-    for (int i = 0; i < m_Size; i++)
+    // all in-degree edges, read from the reverse list
+    for (auto const &item : m_InList[vertex])
     {
-        if (i == vertex) continue;
-        
-        for (auto const& item : m_List[i])
-        {
-            if (item.first == vertex)
-            {
-                // add i as neighborhood
-                m->insert(make_pair(i, item.second));
-            }
-        }
+        if (item.first == vertex) continue;
+
+        // add source as neighborhood
+        m->insert(make_pair(item.first, item.second));
     }
 }
 
@@ -53,33 +49,116 @@ void ListGraph::getAdjacentEdgesDirect(int vertex, multimap<int, int> *m)
 // Insert edge
 void ListGraph::insertEdge(int from, int to, int weight)
 {
+    if (from < 0 || from >= m_Size || to < 0 || to >= m_Size)
+        return;
+
     m_List[from].insert(make_pair(to, weight));
+    m_InList[to].insert(make_pair(from, weight));
+    m_EdgeCount++;
+}
+
+// Delete every from -> to edge, parallel edges included
+int ListGraph::deleteEdge(int from, int to)
+{
+    if (from < 0 || from >= m_Size || to < 0 || to >= m_Size)
+        return 0;
+
+    int removed = (int)m_List[from].erase(to);
+    m_InList[to].erase(from);
+    m_EdgeCount -= removed;
+    return removed;
+}
+
+// Change the weight of every from -> to edge in both lists
+int ListGraph::updateWeight(int from, int to, int weight)
+{
+    if (from < 0 || from >= m_Size || to < 0 || to >= m_Size)
+        return 0;
+
+    int changed = 0;
+    auto out = m_List[from].equal_range(to);
+    for (auto it = out.first; it != out.second; it++, changed++)
+        it->second = weight;
+    auto in = m_InList[to].equal_range(from);
+    for (auto it = in.first; it != in.second; it++)
+        it->second = weight;
+    return changed;
+}
+
+// visit edges without building a multimap, ascending neighbor order
+void ListGraph::visitEdges(int vertex, EdgeDirection dir, EdgeVisitor visit, void *context)
+{
+    if (vertex < 0 || vertex >= m_Size)
+        return;
+
+    if (dir == EDGE_OUT)
+    {
+        for (auto const &item : m_List[vertex])
+        {
+            if (!visit(context, item.first, item.second))
+                return;
+        }
+        return;
+    }
+    if (dir == EDGE_IN)
+    {
+        for (auto const &item : m_InList[vertex])
+        {
+            if (!visit(context, item.first, item.second))
+                return;
+        }
+        return;
+    }
+
+    // undirected : merge the two sorted lists, self loop only once
+    multimap<int, int>::iterator out = m_List[vertex].begin();
+    multimap<int, int>::iterator in = m_InList[vertex].begin();
+    while (out != m_List[vertex].end() || in != m_InList[vertex].end())
+    {
+        if (in != m_InList[vertex].end() && in->first == vertex)
+        {
+            in++;
+            continue;
+        }
+        if (in == m_InList[vertex].end() || (out != m_List[vertex].end() && out->first <= in->first))
+        {
+            if (!visit(context, out->first, out->second))
+                return;
+            out++;
+        }
+        else
+        {
+            if (!visit(context, in->first, in->second))
+                return;
+            in++;
+        }
+    }
 }
 // print graph, List perspective
-bool ListGraph::printGraph(ofstream *fout)
+bool ListGraph::printGraph(ostream *fout)
 {
     if (m_Size < 0)
         return false;
 
     *fout << "========PRINT========" << endl;
-    for (int i = 0; i < m_Size; i++)
+    // rows formatted in parallel blocks
+    writeRows(*fout, m_Size, [&](int i, TextBuffer &text)
     {
-        *fout << "[" << i << "]";
+        text.putLabel(i);
         // no connected edge
         if (m_List[i].empty())
-        {
-            *fout << "->" << endl;
-        }
+            text.put("->");
         // connected edge
-        else
+        for (auto const &item : m_List[i])
         {
-            for (auto const &item : m_List[i])
-            {
-                *fout << "->(" << item.first << "," << item.second << ")";
-            }
-            *fout << endl;
+            text.put("->(");
+            text.putInt(item.first);
+            text.put(',');
+            text.putInt(item.second);
+            text.put(')');
         }
-    }
+        text.put('\n');
+    });
     *fout << "=====================\n\n";
     return true;
 }
\ No newline at end of file
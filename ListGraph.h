@@ -6,8 +6,8 @@
 class ListGraph : public Graph
 {
 private:
-	multimap<int, int> *m_List;
-	vector<int> *kw_graph;
+	multimap<int, int> *m_List;   // out-degree edges (to, weight)
+	multimap<int, int> *m_InList; // in-degree edges (from, weight)
 
 public:
 	ListGraph(bool type, int size);
@@ -16,7 +16,10 @@ public:
 	void getAdjacentEdges(int vertex, multimap<int, int> *m);
 	void getAdjacentEdgesDirect(int vertex, multimap<int, int> *m);
 	void insertEdge(int from, int to, int weight);
-	bool printGraph(ofstream *fout);
+	int deleteEdge(int from, int to);
+	int updateWeight(int from, int to, int weight);
+	bool printGraph(ostream *fout);
+	void visitEdges(int vertex, EdgeDirection dir, EdgeVisitor visit, void *context);
 };
 
 #endif
\ No newline at end of file
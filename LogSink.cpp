@@ -0,0 +1,158 @@
+#include "LogSink.h"
+
+LogBuffer::LogBuffer()
+{
+	m_File = nullptr;
+	m_Background = false;
+	m_Writing = false;
+	m_Stop = false;
+	setp(nullptr, nullptr);
+}
+
+LogBuffer::~LogBuffer()
+{
+	close();
+}
+
+bool LogBuffer::open(const char *filename, bool background)
+{
+	close();
+	m_File = fopen(filename, "wb");
+	if (m_File == nullptr)
+		return false;
+	// blocks are already large, no second copy through stdio
+	setvbuf(m_File, nullptr, _IONBF, 0);
+
+	m_Block.resize(LOG_BLOCK_SIZE);
+	setp(m_Block.data(), m_Block.data() + m_Block.size());
+	m_Background = background;
+	m_Stop = false;
+	if (m_Background)
+		m_Writer = thread(&LogBuffer::writerLoop, this);
+	return true;
+}
+
+void LogBuffer::handOff()
+{
+	size_t bytes = pptr() - pbase();
+	if (bytes == 0)
+		return;
+
+	if (!m_Background)
+	{
+		fwrite(m_Block.data(), 1, bytes, m_File);
+	}
+	else
+	{
+		unique_lock<mutex> lock(m_Lock);
+		// bounded queue, formatting waits once the disk falls too far behind
+		m_Written.wait(lock, [this] { return m_Queue.size() < LOG_MAX_PENDING; });
+		m_Block.resize(bytes);
+		m_Queue.push_back(vector<char>());
+		m_Queue.back().swap(m_Block);
+		if (!m_Spare.empty())
+		{
+			m_Block.swap(m_Spare.back());
+			m_Spare.pop_back();
+		}
+		m_Queued.notify_one();
+	}
+	m_Block.resize(LOG_BLOCK_SIZE);
+	setp(m_Block.data(), m_Block.data() + m_Block.size());
+}
+
+void LogBuffer::writerLoop()
+{
+	unique_lock<mutex> lock(m_Lock);
+	while (true)
+	{
+		m_Queued.wait(lock, [this] { return !m_Queue.empty() || m_Stop; });
+		if (m_Queue.empty())
+			break;
+
+		vector<char> block;
+		block.swap(m_Queue.front());
+		m_Queue.pop_front();
+		m_Writing = true;
+		// the file is written without the lock, the producer keeps formatting
+		lock.unlock();
+		fwrite(block.data(), 1, block.size(), m_File);
+		lock.lock();
+		m_Writing = false;
+		m_Spare.push_back(vector<char>());
+		m_Spare.back().swap(block);
+		m_Written.notify_all();
+	}
+}
+
+LogBuffer::int_type LogBuffer::overflow(int_type c)
+{
+	if (m_File == nullptr)
+		return traits_type::eof();
+	handOff();
+	if (!traits_type::eq_int_type(c, traits_type::eof()))
+	{
+		*pptr() = traits_type::to_char_type(c);
+		pbump(1);
+	}
+	return traits_type::not_eof(c);
+}
+
+int LogBuffer::sync()
+{
+	return 0;
+}
+
+void LogBuffer::commit()
+{
+	if (m_File == nullptr)
+		return;
+	handOff();
+	if (m_Background)
+	{
+		unique_lock<mutex> lock(m_Lock);
+		m_Written.wait(lock, [this] { return m_Queue.empty() && !m_Writing; });
+	}
+	fflush(m_File);
+}
+
+void LogBuffer::close()
+{
+	if (m_File == nullptr)
+		return;
+	commit();
+	if (m_Background)
+	{
+		{
+			lock_guard<mutex> lock(m_Lock);
+			m_Stop = true;
+		}
+		m_Queued.notify_one();
+		m_Writer.join();
+	}
+	fclose(m_File);
+	m_File = nullptr;
+	setp(nullptr, nullptr);
+	vector<char>().swap(m_Block);
+	vector<vector<char>>().swap(m_Spare);
+}
+
+LogSink::LogSink() : ostream(nullptr)
+{
+	rdbuf(&m_Buffer);
+}
+
+bool LogSink::open(const char *filename, bool background)
+{
+	clear();
+	resetFormat();
+	return m_Buffer.open(filename, background);
+}
+
+void LogSink::resetFormat()
+{
+	flags(ios_base::skipws | ios_base::dec);
+	precision(6);
+	width(0);
+	fill(' ');
+}
@@ -0,0 +1,75 @@
+#ifndef _LOGSINK_H_
+#define _LOGSINK_H_
+
+#include <cstdio>
+#include <ostream>
+#include <streambuf>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+using namespace std;
+
+// Bytes gathered before a block is handed to the file
+const size_t LOG_BLOCK_SIZE = 1 << 20;
+// Blocks the background writer may fall behind before the producer waits
+const size_t LOG_MAX_PENDING = 4;
+
+// Stream buffer behind LogSink, one open file and large output blocks
+// sync() (std::endl, flush) does nothing, a block leaves when full or on commit()
+// with the background writer, full blocks are queued and written by a separate thread
+class LogBuffer : public streambuf
+{
+private:
+	FILE *m_File;
+	bool m_Background;
+	vector<char> m_Block; // block being filled
+
+	thread m_Writer;
+	mutex m_Lock;
+	condition_variable m_Queued;  // writer side : block queued or stop requested
+	condition_variable m_Written; // producer side : a queued block was written
+	deque<vector<char>> m_Queue;  // full blocks waiting for the writer
+	vector<vector<char>> m_Spare; // written blocks, reused as the next m_Block
+	bool m_Writing;				  // writer holds a block taken off the queue
+	bool m_Stop;
+
+	void handOff(); // current block to the file or the queue, a fresh one to fill
+	void writerLoop();
+
+protected:
+	int_type overflow(int_type c);
+	int sync();
+
+public:
+	LogBuffer();
+	~LogBuffer();
+
+	bool open(const char *filename, bool background);
+	bool isOpen() { return m_File != nullptr; }
+	void commit(); // every byte written so far reaches the file
+	void close();
+};
+
+// Output sink of one run, owned by Manager and passed to every command
+// an ostream, so algorithms format with << as before
+class LogSink : public ostream
+{
+private:
+	LogBuffer m_Buffer;
+
+public:
+	LogSink();
+
+	// truncates filename, background selects the writer thread
+	bool open(const char *filename, bool background = true);
+	bool isOpen() { return m_Buffer.isOpen(); }
+	void commit() { m_Buffer.commit(); }
+	void close() { m_Buffer.close(); }
+	// default number format, so fixed / setprecision of one command do not leak into the next
+	void resetFormat();
+};
+
+#endif
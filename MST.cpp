@@ -0,0 +1,305 @@
+#include "MST.h"
+#include "Parallel.h"
+#include "MatrixGraph.h"
+
+DisjointSet::DisjointSet(int n) : parent(n), rank(n, 0)
+{
+	for (int i = 0; i < n; i++)
+		parent[i] = i;
+}
+
+int DisjointSet::find(int u)
+{
+	// every visited vertex skips to its grandparent
+	while (parent[u] != u)
+	{
+		parent[u] = parent[parent[u]];
+		u = parent[u];
+	}
+	return u;
+}
+
+bool DisjointSet::merge(int u, int v)
+{
+	u = find(u);
+	v = find(v);
+	if (u == v)
+		return false;
+	// lower rank goes under higher rank
+	if (rank[u] < rank[v])
+		swap(u, v);
+	parent[v] = u;
+	if (rank[u] == rank[v])
+		rank[u]++;
+	return true;
+}
+
+static inline unsigned long long packNode(unsigned rank, int parent)
+{
+	return (unsigned long long)rank << 32 | (unsigned)parent;
+}
+
+static inline int parentOf(unsigned long long node)
+{
+	return (int)(node & 0xffffffffULL);
+}
+
+static inline unsigned rankOf(unsigned long long node)
+{
+	return (unsigned)(node >> 32);
+}
+
+ConcurrentDisjointSet::ConcurrentDisjointSet(int size) : m_Node(size)
+{
+	for (int i = 0; i < size; i++)
+		m_Node[i].store(packNode(0, i), memory_order_relaxed);
+}
+
+int ConcurrentDisjointSet::find(int u)
+{
+	while (true)
+	{
+		unsigned long long node = m_Node[u].load();
+		int p = parentOf(node);
+		if (p == u)
+			return u;
+		int gp = parentOf(m_Node[p].load());
+		// path halving, a lost race only skips the shortcut
+		if (gp != p)
+			m_Node[u].compare_exchange_weak(node, packNode(rankOf(node), gp));
+		u = gp;
+	}
+}
+
+bool ConcurrentDisjointSet::merge(int u, int v)
+{
+	while (true)
+	{
+		u = find(u);
+		v = find(v);
+		if (u == v)
+			return false;
+		unsigned long long nu = m_Node[u].load(), nv = m_Node[v].load();
+		if (parentOf(nu) != u || parentOf(nv) != v)
+			continue; // linked by another thread meanwhile
+		// the smaller (rank, id) root goes under the larger one, ranks only grow so no cycle can form
+		if (rankOf(nu) > rankOf(nv) || (rankOf(nu) == rankOf(nv) && u > v))
+		{
+			swap(u, v);
+			swap(nu, nv);
+		}
+		if (!m_Node[u].compare_exchange_strong(nu, packNode(rankOf(nu), v)))
+			continue;
+		if (rankOf(nu) == rankOf(nv))
+			m_Node[v].compare_exchange_strong(nv, packNode(rankOf(nv) + 1, v));
+		return true;
+	}
+}
+
+// Sums the tree cost, a spanning tree has size - 1 edges
+static bool finishTree(int size, const vector<Edge> &tree, int &cost)
+{
+	cost = 0;
+	for (size_t i = 0; i < tree.size(); i++)
+		cost += tree[i].weight;
+	return size == 0 || (int)tree.size() == size - 1;
+}
+
+bool minimumSpanningTree(Graph *graph, vector<Edge> &tree, int &cost)
+{
+	int size = graph->getSize();
+	int workers = workerCount();
+
+	tree.clear();
+	if (dynamic_cast<MatrixGraph *>(graph) != nullptr || (long long)graph->getEdgeCount() * PRIM_DENSITY_RATIO >= (long long)size * size)
+	{
+		// dense : no edge list at all
+		densePrim(graph, tree);
+		return finishTree(size, tree, cost);
+	}
+
+	// Collect all edges of the graph once (u < v), one piece per worker
+	vector<vector<Edge>> part(workers);
+	parallelFor(0, size, [&](int u, int worker)
+	{
+		graph->forEachEdge(u, EDGE_BOTH, [&](int v, int w)
+		{
+			if (u < v)
+			{
+				Edge edge = {u, v, w};
+				part[worker].push_back(edge);
+			}
+		});
+	});
+	vector<Edge> edges;
+	for (int w = 0; w < workers; w++)
+	{
+		edges.insert(edges.end(), part[w].begin(), part[w].end());
+		vector<Edge>().swap(part[w]);
+	}
+
+	if (edges.size() >= (size_t)BORUVKA_MIN_EDGES && workers > 1)
+		parallelBoruvka(size, edges, tree);
+	else
+		filterKruskal(size, edges, tree);
+	return finishTree(size, tree, cost);
+}
+
+static void filterKruskalRange(vector<Edge>::iterator begin, vector<Edge>::iterator end, DisjointSet &sets, vector<Edge> &tree)
+{
+	// every remaining edge sits in [begin, end), stop once the tree spans
+	if (begin == end || tree.size() + 1 == sets.parent.size())
+		return;
+
+	vector<Edge>::iterator split = end;
+	if (end - begin > FILTER_KRUSKAL_CUTOFF)
+	{
+		// median of three pivot, light edges (<= pivot) first
+		Edge a = *begin, b = *(begin + (end - begin) / 2), c = *(end - 1);
+		Edge pivot = a < b ? (b < c ? b : (a < c ? c : a)) : (a < c ? a : (b < c ? c : b));
+		split = partition(begin, end, [&](const Edge &e) { return !(pivot < e); });
+	}
+	if (split == end)
+	{
+		// plain Kruskal
+		sort(begin, end);
+		for (vector<Edge>::iterator it = begin; it != end && tree.size() + 1 < sets.parent.size(); ++it)
+		{
+			if (sets.merge(it->u, it->v))
+				tree.push_back(*it);
+		}
+		return;
+	}
+
+	filterKruskalRange(begin, split, sets, tree);
+	// heavy edges already inside one component can never join the tree
+	vector<Edge>::iterator keep = partition(split, end, [&](const Edge &e) { return sets.find(e.u) != sets.find(e.v); });
+	filterKruskalRange(split, keep, sets, tree);
+}
+
+void filterKruskal(int size, vector<Edge> &edges, vector<Edge> &tree)
+{
+	DisjointSet sets(size);
+	filterKruskalRange(edges.begin(), edges.end(), sets, tree);
+}
+
+void parallelBoruvka(int size, vector<Edge> &edges, vector<Edge> &tree)
+{
+	ConcurrentDisjointSet sets(size);
+	vector<atomic<int>> best(size); // lightest edge leaving each component
+	vector<char> chosen;
+
+	while (!edges.empty())
+	{
+		int count = (int)edges.size();
+		parallelFor(0, size, [&](int c, int)
+		{
+			best[c].store(-1, memory_order_relaxed);
+		});
+
+		// every edge offers itself to both of its components
+		parallelFor(0, count, [&](int i, int)
+		{
+			int cu = sets.find(edges[i].u), cv = sets.find(edges[i].v);
+			if (cu == cv)
+				return;
+			int roots[2] = {cu, cv};
+			for (int k = 0; k < 2; k++)
+			{
+				int cur = best[roots[k]].load();
+				while ((cur == -1 || edges[i] < edges[cur]) && !best[roots[k]].compare_exchange_weak(cur, i))
+					;
+			}
+		});
+
+		// hook along the lightest edges, two components choosing the same edge merge once
+		chosen.assign(count, 0);
+		parallelFor(0, size, [&](int c, int)
+		{
+			int i = best[c].load(memory_order_relaxed);
+			if (i != -1 && sets.merge(edges[i].u, edges[i].v))
+				chosen[i] = 1;
+		});
+		for (int i = 0; i < count; i++)
+		{
+			if (chosen[i])
+				tree.push_back(edges[i]);
+		}
+
+		// drop edges that ended up inside one component
+		parallelFor(0, count, [&](int i, int)
+		{
+			chosen[i] = sets.find(edges[i].u) != sets.find(edges[i].v);
+		});
+		int kept = 0;
+		for (int i = 0; i < count; i++)
+		{
+			if (chosen[i])
+				edges[kept++] = edges[i];
+		}
+		edges.resize(kept);
+	}
+}
+
+// Keeps the lighter of best and the edge (u, v, weight)
+static inline void offerEdge(Edge &best, char &reached, int u, int v, int weight)
+{
+	Edge edge = {min(u, v), max(u, v), weight};
+	if (!reached || edge < best)
+	{
+		best = edge;
+		reached = 1;
+	}
+}
+
+void densePrim(Graph *graph, vector<Edge> &tree)
+{
+	int size = graph->getSize();
+	MatrixGraph *matrix = dynamic_cast<MatrixGraph *>(graph);
+	vector<Edge> best(size); // lightest edge from the tree to every outside vertex
+	vector<char> reached(size, 0), inTree(size, 0);
+
+	int u = 0;
+	for (int step = 0; step < size; step++)
+	{
+		inTree[u] = 1;
+		if (step > 0)
+			tree.push_back(best[u]);
+
+		int next = -1;
+		if (matrix != nullptr)
+		{
+			// relax and select in one pass over the row and the column of u
+			const int *row = matrix->getRow(u);
+			const int *col = matrix->getColumn(u);
+			for (int j = 0; j < size; j++)
+			{
+				if (inTree[j])
+					continue;
+				if (row[j] != 0)
+					offerEdge(best[j], reached[j], u, j, row[j]);
+				if (col[j] != 0)
+					offerEdge(best[j], reached[j], u, j, col[j]);
+				if (reached[j] && (next == -1 || best[j] < best[next]))
+					next = j;
+			}
+		}
+		else
+		{
+			graph->forEachEdge(u, EDGE_BOTH, [&](int j, int w)
+			{
+				if (!inTree[j])
+					offerEdge(best[j], reached[j], u, j, w);
+			});
+			for (int j = 0; j < size; j++)
+			{
+				if (!inTree[j] && reached[j] && (next == -1 || best[j] < best[next]))
+					next = j;
+			}
+		}
+		// nothing reachable is left outside the tree
+		if (next == -1)
+			break;
+		u = next;
+	}
+}
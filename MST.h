@@ -0,0 +1,70 @@
+#ifndef _MST_H_
+#define _MST_H_
+
+#include "Graph.h"
+#include <atomic>
+
+// Undirected weighted edge, u < v
+struct Edge
+{
+	int u, v, weight;
+	// Weighted ascending order, ties by endpoints so the order is total
+	bool operator<(const Edge &other) const
+	{
+		if (weight != other.weight)
+			return weight < other.weight;
+		if (u != other.u)
+			return u < other.u;
+		return v < other.v;
+	}
+};
+
+// Union-Find with union by rank and path halving
+struct DisjointSet
+{
+	vector<int> parent;
+	vector<int> rank;
+
+	DisjointSet(int n);
+	int find(int u);
+	bool merge(int u, int v); // false if u and v were already in one set
+};
+
+// Lock-free Union-Find for the parallel algorithms
+// rank and parent share one word, so linking a root is a single compare-and-swap
+class ConcurrentDisjointSet
+{
+private:
+	vector<atomic<unsigned long long>> m_Node; // rank << 32 | parent
+
+public:
+	ConcurrentDisjointSet(int size);
+
+	int find(int u);
+	bool merge(int u, int v); // false if u and v were already in one set
+};
+
+// Filter-Kruskal sorts ranges up to this many edges directly
+const int FILTER_KRUSKAL_CUTOFF = 1024;
+
+// Parallel Boruvka is used from this many edges on
+const int BORUVKA_MIN_EDGES = 1 << 18;
+
+// Array based Prim is used for MatrixGraph and when edges * PRIM_DENSITY_RATIO >= vertices^2
+const int PRIM_DENSITY_RATIO = 4;
+
+// Minimum spanning tree of the undirected view, edges are taken in Edge order
+// so every algorithm returns the same tree, false if the graph is disconnected
+bool minimumSpanningTree(Graph *graph, vector<Edge> &tree, int &cost);
+
+// Kruskal on light / heavy partitions, heavy edges inside one component are dropped before sorting
+void filterKruskal(int size, vector<Edge> &edges, vector<Edge> &tree);
+
+// O(V^2) Prim with a lightest-edge array, no edge list and no sort
+// MatrixGraph rows are read directly, other graphs through the edge visitor
+void densePrim(Graph *graph, vector<Edge> &tree);
+
+// Every component hooks along its lightest edge each round, edges are scanned in parallel
+void parallelBoruvka(int size, vector<Edge> &edges, vector<Edge> &tree);
+
+#endif
@@ -2,6 +2,9 @@
 #include "GraphMethod.h"
 #include "ListGraph.h"
 #include "MatrixGraph.h"
+#include "CSRGraph.h"
+#include "GraphFile.h"
+#include "TextLoader.h"
 #include <iostream>
 #include <fstream>
 #include <vector>
@@ -15,14 +18,47 @@ struct CommandData
 {
 	string command;
 	string filename;
+	vector<string> flags; // optional trailing keywords (e.g. LOAD ... CSR)
 	char option;
 	int vertex;		// start node
 	int destVertex; // destination  node
+	vector<int> vertices; // source list (MSBFS)
+	int number;			  // numeric argument (CACHE budget in KB, APPROX pivots, TOP count, edge weight), -1 if absent
+	int sample;			  // SAMPLE source count (BETWEENNESS), -1 if absent
 	bool isValid;	// parameter is approptiate
 
-	CommandData() : command(""), filename(""), option('\0'), vertex(-1), destVertex(-1), isValid(true) {}
+	CommandData() : command(""), filename(""), option('\0'), vertex(-1), destVertex(-1), number(-1), sample(-1), isValid(true) {}
+
+	bool hasFlag(const string &flag) const
+	{
+		for (size_t i = 0; i < flags.size(); i++)
+		{
+			if (flags[i] == flag)
+				return true;
+		}
+		return false;
+	}
 };
 
+// Reads optional trailing keywords into data.flags
+// each keyword must be listed in allowed and may appear once
+static void parseFlags(stringstream &ss, CommandData &data, const char *const allowed[], int count)
+{
+	string word;
+	while (ss >> word)
+	{
+		bool known = false;
+		for (int i = 0; i < count; i++)
+		{
+			if (word == allowed[i])
+				known = true;
+		}
+		if (!known || data.hasFlag(word))
+			data.isValid = false; // inappropriate command
+		data.flags.push_back(word);
+	}
+}
+
 // Parses a raw string line into CommandData structure
 CommandData CommandParsing(string line)
 {
@@ -41,33 +77,148 @@ CommandData CommandParsing(string line)
 	// Distinguish the number of factors by command
 	if (data.command == "LOAD")
 	{
-		// need 1 filename parameter
+		// need 1 filename parameter, optional CSR representation keyword
+		static const char *const allowed[] = {"CSR"};
 		ss >> data.filename;
-		if (ss.fail() || (ss >> extraArg))
+		if (ss.fail())
 			data.isValid = false; // inappropriate command
+		else
+			parseFlags(ss, data, allowed, 1);
 	}
-	else if (data.command == "BFS" || data.command == "DFS" || data.command == "DIJKSTRA")
+	else if (data.command == "SAVE")
+	{
+		// need 1 filename parameter, optional COMPACT keyword (no in-edge index)
+		static const char *const allowed[] = {"COMPACT"};
+		ss >> data.filename;
+		if (ss.fail())
+			data.isValid = false; // inappropriate command
+		else
+			parseFlags(ss, data, allowed, 1);
+	}
+	else if (data.command == "DIJKSTRA")
+	{
+		// need 2 parameter, optional SEQ / DELTA algorithm keyword and BIN export
+		static const char *const allowed[] = {"SEQ", "DELTA", "BIN"};
+		ss >> data.option >> data.vertex;
+		if (ss.fail())
+			data.isValid = false; // inappropriate command
+		else
+			parseFlags(ss, data, allowed, 3);
+		if (data.hasFlag("SEQ") && data.hasFlag("DELTA"))
+			data.isValid = false;
+	}
+	else if (data.command == "BFS" || data.command == "DFS")
 	{
 		// need 2 parameter
 		ss >> data.option >> data.vertex;
 		if (ss.fail() || (ss >> extraArg))
 			data.isValid = false; // inappropriate command
 	}
-	else if (data.command == "BELLMANFORD")
+	else if (data.command == "MSBFS")
+	{
+		// need option and at least 1 vertex
+		int vertex;
+		ss >> data.option;
+		while (ss >> vertex)
+			data.vertices.push_back(vertex);
+		if (!ss.eof() || data.vertices.empty())
+			data.isValid = false; // inappropriate command
+	}
+	else if (data.command == "BELLMANFORD" || data.command == "SHORTESTPATH")
 	{
 		// need 3 parameter
 		ss >> data.option >> data.vertex >> data.destVertex;
 		if (ss.fail() || (ss >> extraArg))
 			data.isValid = false; // inappropriate command
 	}
+	else if (data.command == "INSERT_EDGE" || data.command == "UPDATE_WEIGHT")
+	{
+		// need from, to and weight
+		ss >> data.vertex >> data.destVertex >> data.number;
+		if (ss.fail() || (ss >> extraArg))
+			data.isValid = false; // inappropriate command
+	}
+	else if (data.command == "DELETE_EDGE")
+	{
+		// need from and to
+		ss >> data.vertex >> data.destVertex;
+		if (ss.fail() || (ss >> extraArg))
+			data.isValid = false; // inappropriate command
+	}
+	else if (data.command == "CHQUERY")
+	{
+		// need 2 vertex parameter
+		ss >> data.vertex >> data.destVertex;
+		if (ss.fail() || (ss >> extraArg))
+			data.isValid = false; // inappropriate command
+	}
 	else if (data.command == "FLOYD")
+	{
+		// need 1 option parameter, optional BIN export
+		static const char *const allowed[] = {"BIN"};
+		ss >> data.option;
+		if (ss.fail())
+			data.isValid = false; // inappropriate command
+		else
+			parseFlags(ss, data, allowed, 1);
+	}
+	else if (data.command == "CHBUILD")
 	{
 		// need 1 option parameter
 		ss >> data.option;
 		if (ss.fail() || (ss >> extraArg))
 			data.isValid = false; // inappropriate command
 	}
-	else if (data.command == "PRINT" || data.command == "KRUSKAL" || data.command == "CENTRALITY")
+	else if (data.command == "CACHE")
+	{
+		// optional budget in KB
+		if (ss >> data.number)
+		{
+			if (data.number < 0 || (ss >> extraArg))
+				data.isValid = false; // inappropriate command
+		}
+		else if (!ss.eof())
+			data.isValid = false;
+	}
+	else if (data.command == "BETWEENNESS")
+	{
+		// need option, optional TOP k and SAMPLE s
+		string word;
+		ss >> data.option;
+		if (ss.fail())
+			data.isValid = false; // inappropriate command
+		while (data.isValid && ss >> word)
+		{
+			int *target = word == "TOP" ? &data.number : word == "SAMPLE" ? &data.sample : nullptr;
+			if (target == nullptr || *target != -1 || !(ss >> *target) || *target < 1)
+				data.isValid = false;
+		}
+	}
+	else if (data.command == "CENTRALITY")
+	{
+		// optional EXACT, or APPROX with the pivot count, then optional BIN export
+		string mode;
+		if (ss >> mode && mode != "BIN")
+		{
+			if (mode == "APPROX")
+			{
+				if (!(ss >> data.number) || data.number < 1)
+					data.isValid = false; // inappropriate command
+			}
+			else if (mode != "EXACT")
+				data.isValid = false;
+			data.flags.push_back(mode);
+			ss >> mode;
+		}
+		if (!ss.fail() && mode == "BIN")
+		{
+			data.flags.push_back(mode);
+			ss >> mode;
+		}
+		if (!ss.fail())
+			data.isValid = false; // unknown or repeated keyword
+	}
+	else if (data.command == "PRINT" || data.command == "KRUSKAL")
 	{
 		if (ss >> extraArg)
 			data.isValid = false; // inappropriate command
@@ -78,26 +229,31 @@ CommandData CommandParsing(string line)
 Manager::Manager()
 {
 	graph = nullptr;
+	p2p = nullptr;
+	ch = nullptr;
+	chPending = '\0';
 	load = 0;
+	positive = true;
 }
 
 Manager::~Manager()
 {
 	if (load && graph != nullptr) // It's been loaded, and if graph data exists
 		delete graph;
+	delete p2p;
+	delete ch;
 }
 
 void Manager::run(const char *command_txt)
 {
-	ofstream clearFout("log.txt", ios::trunc);
-	clearFout.close();
+	// log.txt stays open for the whole run, written in large blocks
+	fout.open("log.txt");
 
 	ifstream fin;
 	fin.open(command_txt, ios_base::in);
 
 	if (!fin)
 	{
-		fout.open("log.txt", ios::app);
 		fout << "command file open error" << endl;
 		fout.close();
 		return;
@@ -112,12 +268,19 @@ void Manager::run(const char *command_txt)
 		CommandData cmdData = CommandParsing(line);
 		if (cmdData.command.empty())
 			continue;
+		fout.resetFormat();
 		// LOAD
 		if (cmdData.command == "LOAD")
 		{
-			if (!cmdData.isValid || cmdData.filename.empty() || !LOAD(cmdData.filename.c_str()))
+			if (!cmdData.isValid || cmdData.filename.empty() || !LOAD(cmdData.filename.c_str(), cmdData.hasFlag("CSR")))
 				printErrorCode(100);
 		}
+		// SAVE
+		else if (cmdData.command == "SAVE")
+		{
+			if (!cmdData.isValid || cmdData.filename.empty() || !mSAVE(cmdData.filename.c_str(), !cmdData.hasFlag("COMPACT")))
+				printErrorCode(1900);
+		}
 		// PRINT
 		else if (cmdData.command == "PRINT")
 		{
@@ -145,7 +308,13 @@ void Manager::run(const char *command_txt)
 		// DIJKSTRA
 		else if (cmdData.command == "DIJKSTRA")
 		{
-			if (!cmdData.isValid || cmdData.option == '\0' || cmdData.vertex == -1 || !mDIJKSTRA(cmdData.option, cmdData.vertex))
+			SSSPMode mode = SSSP_AUTO;
+			if (cmdData.hasFlag("SEQ"))
+				mode = SSSP_SEQUENTIAL;
+			else if (cmdData.hasFlag("DELTA"))
+				mode = SSSP_DELTA;
+
+			if (!cmdData.isValid || cmdData.option == '\0' || cmdData.vertex == -1 || !mDIJKSTRA(cmdData.option, cmdData.vertex, mode, cmdData.hasFlag("BIN")))
 				printErrorCode(600);
 		}
 		// BELLMANFORD
@@ -157,37 +326,94 @@ void Manager::run(const char *command_txt)
 		// FLOYD
 		else if (cmdData.command == "FLOYD")
 		{
-			if (!cmdData.isValid || cmdData.option == '\0' || !mFLOYD(cmdData.option))
+			if (!cmdData.isValid || cmdData.option == '\0' || !mFLOYD(cmdData.option, cmdData.hasFlag("BIN")))
 				printErrorCode(800);
 		}
 		// CENTRALITY
 		else if (cmdData.command == "CENTRALITY")
 		{
-			if (!cmdData.isValid || !mCentrality())
+			int pivots = cmdData.hasFlag("APPROX") ? cmdData.number : 0;
+			if (!cmdData.isValid || !mCentrality(pivots, cmdData.hasFlag("BIN")))
 				printErrorCode(900);
 		}
+		// SHORTESTPATH
+		else if (cmdData.command == "SHORTESTPATH")
+		{
+			if (!cmdData.isValid || cmdData.option == '\0' || cmdData.vertex == -1 || cmdData.destVertex == -1 || !mSHORTESTPATH(cmdData.option, cmdData.vertex, cmdData.destVertex))
+				printErrorCode(1000);
+		}
+		// CHBUILD
+		else if (cmdData.command == "CHBUILD")
+		{
+			if (!cmdData.isValid || cmdData.option == '\0' || !mCHBUILD(cmdData.option))
+				printErrorCode(1100);
+		}
+		// CHQUERY
+		else if (cmdData.command == "CHQUERY")
+		{
+			if (!cmdData.isValid || cmdData.vertex == -1 || cmdData.destVertex == -1 || !mCHQUERY(cmdData.vertex, cmdData.destVertex))
+				printErrorCode(1200);
+		}
+		// MSBFS
+		else if (cmdData.command == "MSBFS")
+		{
+			if (!cmdData.isValid || cmdData.option == '\0' || !mMSBFS(cmdData.option, cmdData.vertices))
+				printErrorCode(1300);
+		}
+		// BETWEENNESS
+		else if (cmdData.command == "BETWEENNESS")
+		{
+			if (!cmdData.isValid || cmdData.option == '\0' || !mBETWEENNESS(cmdData.option, cmdData.number, cmdData.sample))
+				printErrorCode(1500);
+		}
+		// INSERT_EDGE
+		else if (cmdData.command == "INSERT_EDGE")
+		{
+			if (!cmdData.isValid || !mINSERTEDGE(cmdData.vertex, cmdData.destVertex, cmdData.number))
+				printErrorCode(1600);
+		}
+		// DELETE_EDGE
+		else if (cmdData.command == "DELETE_EDGE")
+		{
+			if (!cmdData.isValid || !mDELETEEDGE(cmdData.vertex, cmdData.destVertex))
+				printErrorCode(1700);
+		}
+		// UPDATE_WEIGHT
+		else if (cmdData.command == "UPDATE_WEIGHT")
+		{
+			if (!cmdData.isValid || !mUPDATEWEIGHT(cmdData.vertex, cmdData.destVertex, cmdData.number))
+				printErrorCode(1800);
+		}
+		// CACHE
+		else if (cmdData.command == "CACHE")
+		{
+			if (!cmdData.isValid || !mCACHE(cmdData.number))
+				printErrorCode(1400);
+		}
 		// EXIT
 		else if (cmdData.command == "EXIT")
 		{
-			fout.open("log.txt", ios::app);
 			fout << "========EXIT========" << endl;
 			fout << "Success" << endl;
 			fout << "====================\n\n";
-			fout.close();
 			break;
 		}
+		// every finished command is on disk before the next one starts
+		fout.commit();
 	}
 	fin.close();
+	fout.close();
 }
 
-// LOAD
-bool Manager::LOAD(const char *filename)
+// LOAD, csr == true builds a CSRGraph regardless of the file format
+bool Manager::LOAD(const char *filename, bool csr)
 {
 	ifstream gFile(filename); // file open
 	if (!gFile.is_open())
 	{
 		return false;
 	}
+	gFile.close();
 
 	if (load && graph != nullptr)
 	{
@@ -195,92 +421,39 @@ bool Manager::LOAD(const char *filename)
 		graph = nullptr;
 		load = 0;
 	}
-
-	string typeStr; // L or M
-	int size;		// node count
-
-	gFile >> typeStr >> size;
-
-	if (typeStr == "L")
-		graph = new ListGraph(false, size); // Adjacent List
-	else if (typeStr == "M")
-		graph = new MatrixGraph(false, size); // Adjacent Matrix
+	// query workspace, cached results and hierarchy belong to the previous graph
+	apsp.invalidate();
+	trees.clear();
+	components.clear();
+	delete p2p;
+	p2p = nullptr;
+	char chOption = ch != nullptr ? ch->getOption() : chPending;
+	delete ch;
+	ch = nullptr;
+	chPending = '\0';
+
+	// a binary graph file written by SAVE is mapped, a text file is parsed in parallel chunks
+	if (isGraphFile(filename))
+		graph = loadGraphFile(filename);
 	else
-	{
-		gFile.close();
+		graph = loadTextGraph(filename, csr);
+	if (graph == nullptr)
 		return false;
-	}
 
-	if (typeStr == "L") // Adjacent List
-	{
-		string line;
-		getline(gFile, line);
-
-		int currentVertex = -1; // start node
-
-		while (getline(gFile, line))
-		{
-			if (!line.empty() && line.back() == '\r')
-				line.pop_back();
-			if (line.empty())
-				continue;
-			// parsing number in the line
-			stringstream ss(line);
-			vector<int> numbers;
-			int num;
-			while (ss >> num)
-				numbers.push_back(num);
-
-			if (numbers.empty())
-				continue;
-			// if size == 1 -> start node
-			if (numbers.size() == 1)
-			{
-				currentVertex = numbers[0];
-			}
-			// if size != 1 -> start - destination
-			else
-			{
-				// start node is appropriate?
-				if (currentVertex != -1)
-				{
-					// inserting edge of twin node(start, destination)
-					for (size_t i = 0; i < numbers.size(); i += 2)
-					{
-						if (i + 1 < numbers.size())
-						{
-							graph->insertEdge(currentVertex, numbers[i], numbers[i + 1]);
-						}
-					}
-				}
-			}
-		}
-	}
-	else // Matrix
-	{
-		// Create a two-dimensional array by the number of nodes
-		for (int i = 0; i < size; i++)
-		{
-			for (int j = 0; j < size; j++)
-			{
-				int w;
-				gFile >> w;
-				// Inserts as connected edges only if the weight is not zero.
-				if (w != 0)
-					graph->insertEdge(i, j, w);
-			}
-		}
-	}
-
-	gFile.close();
 	load = 1;
+	// component labels for the O(1) disconnection checks
+	components.build(graph);
+	WeightRange range = scanWeights(graph, 'O');
+	positive = !range.hasEdge || range.minWeight > 0;
 
-	fout.open("log.txt", ios::app);
 	// Success output
 	fout << "========LOAD========" << endl;
 	fout << "Success" << endl;
 	fout << "====================\n\n";
-	fout.close();
+
+	// a hierarchy built before is rebuilt for the new graph
+	if (chOption != '\0')
+		rebuildHierarchy(chOption);
 
 	return true;
 }
@@ -291,69 +464,276 @@ bool Manager::PRINT()
 	if (!graph)
 		return false;
 
-	fout.open("log.txt", ios::app);
-	bool result = graph->printGraph(&fout);
-	fout.close();
+	return graph->printGraph(&fout);
+}
+
+// SAVE, reverse == false leaves the in-edge index out of the file
+bool Manager::mSAVE(const char *filename, bool reverse)
+{
+	if (!graph)
+		return false;
 
-	return result;
+	// the text format PRINT follows after the file is loaded back
+	char format = 'L';
+	if (dynamic_cast<MatrixGraph *>(graph) != nullptr)
+		format = 'M';
+	else if (dynamic_cast<CSRGraph *>(graph) != nullptr)
+		format = ((CSRGraph *)graph)->getFormat();
+
+	if (!saveGraphFile(graph, format, filename, reverse))
+		return false;
+
+	fout << "========SAVE========" << endl;
+	fout << "Success" << endl;
+	fout << "====================\n\n";
+	return true;
 }
 // BFS
 bool Manager::mBFS(char option, int vertex)
 {
 	if (!graph) // if no data
 		return false;
-	return BFS(graph, option, vertex);
+	return BFS(fout, graph, option, vertex);
+}
+// MSBFS
+bool Manager::mMSBFS(char option, const vector<int> &sources)
+{
+	if (!graph) // if no data
+		return false;
+	return MSBFS(fout, graph, option, sources);
+}
+// BETWEENNESS, top / samples <= 0 use the defaults (10 vertices, every source)
+bool Manager::mBETWEENNESS(char option, int top, int samples)
+{
+	if (!graph) // if no data
+		return false;
+	return Betweenness(fout, graph, option, top, samples);
+}
+// CACHE, budgetKB >= 0 resizes the tree cache first
+bool Manager::mCACHE(int budgetKB)
+{
+	if (budgetKB >= 0)
+		trees.setBudget((size_t)budgetKB << 10);
+	return CacheStats(fout, &trees);
 }
 // DFS
 bool Manager::mDFS(char option, int vertex)
 {
 	if (!graph) // if no data
 		return false;
-	return DFS(graph, option, vertex);
+	return DFS(fout, graph, option, vertex);
 }
 // Dijkstra
-bool Manager::mDIJKSTRA(char option, int vertex)
+bool Manager::mDIJKSTRA(char option, int vertex, SSSPMode mode, bool binary)
 {
 	if (!graph) // if no data
 		return false;
-	return Dijkstra(graph, option, vertex);
+	return Dijkstra(fout, graph, option, vertex, mode, &apsp, &trees, binary);
 }
 // Kruskal
 bool Manager::mKRUSKAL()
 {
 	if (!graph) // if no data
 		return false;
-	return Kruskal(graph);
+	return Kruskal(fout, graph, &components);
 }
 // Bellmanford
 bool Manager::mBELLMANFORD(char option, int s_vertex, int e_vertex)
 {
 	if (!graph) // if no data
 		return false;
-	return Bellmanford(graph, option, s_vertex, e_vertex);
+	return Bellmanford(fout, graph, option, s_vertex, e_vertex, &apsp, &trees, &components);
 }
 // Floyd
-bool Manager::mFLOYD(char option)
+bool Manager::mFLOYD(char option, bool binary)
 {
 	if (!graph) // if no data
 		return false;
-	return FLOYD(graph, option);
+	return FLOYD(fout, graph, option, &apsp, binary);
 }
 
 // Centrality
-bool Manager::mCentrality()
+bool Manager::mCentrality(int pivots, bool binary)
 {
 	if (!graph) // if no data
 		return false;
-	return Centrality(graph);
+	if (pivots > 0) // sampled
+		return ApproxCentrality(fout, graph, pivots, &components, binary);
+	return Centrality(fout, graph, &apsp, &components, binary);
+}
+
+// s -> t shortest path
+bool Manager::mSHORTESTPATH(char option, int s_vertex, int e_vertex)
+{
+	if (!graph) // if no data
+		return false;
+	if (p2p == nullptr)
+		p2p = new PointToPoint(graph, &components);
+	return ShortestPath(fout, p2p, option, s_vertex, e_vertex);
+}
+
+// Contraction hierarchy preprocessing, weights must be non-negative
+bool Manager::mCHBUILD(char option)
+{
+	if (!graph) // if no data
+		return false;
+	// an explicit build replaces whatever rebuild was pending
+	chPending = '\0';
+	WeightRange range = scanWeights(graph, option);
+	if (range.hasEdge && range.minWeight < 0)
+		return false;
+
+	delete ch;
+	ch = new ContractionHierarchy(graph, option);
+	return CHBuild(fout, ch);
+}
+
+// rebuild of a hierarchy dropped by LOAD, reported like a CHBUILD command
+// a failed rebuild (negative weight) prints 1100 and leaves no hierarchy
+void Manager::rebuildHierarchy(char option)
+{
+	if (!mCHBUILD(option))
+		printErrorCode(1100);
+}
+
+// s -> t query on the hierarchy
+bool Manager::mCHQUERY(int s_vertex, int e_vertex)
+{
+	if (!graph) // if no data
+		return false;
+	// hierarchy dropped by an edge change, rebuilt once for the new weights
+	if (ch == nullptr && chPending != '\0')
+	{
+		WeightRange range = scanWeights(graph, chPending);
+		if (range.hasEdge && range.minWeight < 0)
+			return false;
+		ch = new ContractionHierarchy(graph, chPending);
+		chPending = '\0';
+	}
+	if (ch == nullptr) // if no hierarchy
+		return false;
+	return CHQuery(fout, ch, s_vertex, e_vertex, &components);
+}
+
+// Weights of the from - to connection before an edge command changes the graph
+EdgeChange Manager::beginEdgeChange(int from, int to)
+{
+	EdgeChange change;
+	change.from = from;
+	change.to = to;
+	change.before[0] = connectionWeight(graph, 'O', from, to);
+	change.before[1] = connectionWeight(graph, 'X', from, to);
+	return change;
+}
+
+// Brings the derived state up to date after an edge command and prints the result
+void Manager::endEdgeChange(EdgeChange &change, const char *command)
+{
+	change.after[0] = connectionWeight(graph, 'O', change.from, change.to);
+	change.after[1] = connectionWeight(graph, 'X', change.from, change.to);
+	// only from -> to edges changed, a full scan is needed once a non-positive edge existed
+	bool wasPositive = positive;
+	if (positive)
+		positive = change.after[0] == INF || change.after[0] > 0;
+	else
+	{
+		WeightRange range = scanWeights(graph, 'O');
+		positive = !range.hasEdge || range.minWeight > 0;
+	}
+	change.positive = wasPositive && positive;
+
+	// cheap derived state is rebuilt, the hierarchy waits for the next CHQUERY
+	components.build(graph);
+	delete p2p;
+	p2p = nullptr;
+	if (ch != nullptr)
+	{
+		chPending = ch->getOption();
+		delete ch;
+		ch = nullptr;
+	}
+
+	// cached distances follow the change instead of being recomputed
+	TreeRepair repair(graph->getSize());
+	trees.update([&](int source, char option, SSSPTree &tree)
+	{
+		return updateTree(graph, option, source, change, tree, repair);
+	});
+	const char options[] = {'O', 'X'};
+	for (int i = 0; i < 2; i++)
+	{
+		APSPEntry *entry = apsp.find(options[i]);
+		if (entry != nullptr && !updateAllPairs(graph, options[i], change, *entry))
+			apsp.drop(options[i]);
+	}
+
+	fout << "========" << command << "========" << endl;
+	fout << "Success" << endl;
+	fout << "====================\n\n";
+}
+
+// true for a MatrixGraph and a CSRGraph loaded from an M file, a from -> to pair has at most one edge
+static bool isMatrixFormat(Graph *graph)
+{
+	if (dynamic_cast<MatrixGraph *>(graph) != nullptr)
+		return true;
+	CSRGraph *csr = dynamic_cast<CSRGraph *>(graph);
+	return csr != nullptr && csr->getFormat() == 'M';
+}
+
+// INSERT_EDGE, a list graph keeps parallel edges, a matrix graph overwrites the slot
+bool Manager::mINSERTEDGE(int from, int to, int weight)
+{
+	if (!graph) // if no data
+		return false;
+	int size = graph->getSize();
+	if (from < 0 || from >= size || to < 0 || to >= size)
+		return false;
+	// 0 means no edge in a matrix
+	bool matrix = isMatrixFormat(graph);
+	if (weight == 0 && matrix)
+		return false;
+
+	EdgeChange change = beginEdgeChange(from, to);
+	// a matrix cell holds one edge, inserting overwrites it
+	if (!matrix || graph->updateWeight(from, to, weight) == 0)
+		graph->insertEdge(from, to, weight);
+	endEdgeChange(change, "INSERT_EDGE");
+	return true;
+}
+
+// DELETE_EDGE, every from -> to edge is removed
+bool Manager::mDELETEEDGE(int from, int to)
+{
+	if (!graph) // if no data
+		return false;
+
+	EdgeChange change = beginEdgeChange(from, to);
+	if (graph->deleteEdge(from, to) == 0) // no such edge
+		return false;
+	endEdgeChange(change, "DELETE_EDGE");
+	return true;
+}
+
+// UPDATE_WEIGHT, every from -> to edge gets the new weight
+bool Manager::mUPDATEWEIGHT(int from, int to, int weight)
+{
+	if (!graph) // if no data
+		return false;
+	if (weight == 0 && isMatrixFormat(graph))
+		return false;
+
+	EdgeChange change = beginEdgeChange(from, to);
+	if (graph->updateWeight(from, to, weight) == 0) // no such edge
+		return false;
+	endEdgeChange(change, "UPDATE_WEIGHT");
+	return true;
 }
 
 // ERROR code
 void Manager::printErrorCode(int n)
 {
-	fout.open("log.txt", ios::app);
 	fout << "========ERROR=======" << endl;
 	fout << n << endl;
 	fout << "====================\n\n";
-	fout.close();
 }
\ No newline at end of file
@@ -2,12 +2,24 @@
 #define _MANAGER_H_
 
 #include "GraphMethod.h"
+#include "DynamicPaths.h"
 
 class Manager{	
 private:
 	Graph* graph;	
-	ofstream fout;	
+	PointToPoint* p2p; // SHORTESTPATH workspace, created on first use
+	ContractionHierarchy* ch; // built by CHBUILD, rebuilt on LOAD
+	char chPending; // option of a hierarchy dropped by an edge change, rebuilt by the next CHQUERY
+	APSPCache apsp; // all-pairs results of the loaded graph, cleared on LOAD
+	SSSPCache trees; // recent DIJKSTRA / BELLMANFORD trees, cleared on LOAD
+	ComponentIndex components; // weak / strong component labels, built by LOAD
+	LogSink fout; // log.txt, open for the whole run
 	int load;
+	bool positive; // every edge weight > 0, kept by LOAD and the edge commands
+
+	void rebuildHierarchy(char option);
+	EdgeChange beginEdgeChange(int from, int to);
+	void endEdgeChange(EdgeChange& change, const char* command);
 
 public:
 	Manager();	
@@ -15,15 +27,25 @@ public:
 
 	void run(const char * command_txt);
 	
-	bool LOAD(const char* filename);	
+	bool LOAD(const char* filename, bool csr = false);	
 	bool PRINT();	
+	bool mSAVE(const char* filename, bool reverse);
 	bool mBFS(char option, int vertex);	
 	bool mDFS(char option, int vertex);	
-	bool mDIJKSTRA(char option, int vertex);	
+	bool mDIJKSTRA(char option, int vertex, SSSPMode mode, bool binary);	
 	bool mKRUSKAL();	
 	bool mBELLMANFORD(char option, int s_vertex, int e_vertex);	
-	bool mFLOYD(char option); 
-	bool mCentrality();
+	bool mFLOYD(char option, bool binary); 
+	bool mCentrality(int pivots, bool binary);
+	bool mSHORTESTPATH(char option, int s_vertex, int e_vertex);
+	bool mCHBUILD(char option);
+	bool mCHQUERY(int s_vertex, int e_vertex);
+	bool mMSBFS(char option, const vector<int>& sources);
+	bool mCACHE(int budgetKB);
+	bool mBETWEENNESS(char option, int top, int samples);
+	bool mINSERTEDGE(int from, int to, int weight);
+	bool mDELETEEDGE(int from, int to);
+	bool mUPDATEWEIGHT(int from, int to, int weight);
 	void printErrorCode(int n); 
 };
 
@@ -1,104 +1,189 @@
 #include "MatrixGraph.h"
+#include "TextFormat.h"
 #include <iostream>
 #include <vector>
 #include <iomanip>
 #include <string>
+#include <stdint.h>
 
-// Constructor - Graph Initialization
-MatrixGraph::MatrixGraph(bool type, int size) : Graph(type, size)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+// 32-byte aligned zeroed allocation, the raw pointer is kept just before the block
+static int *alignedAlloc(size_t count)
+{
+	if (count == 0)
+		return nullptr;
+	char *raw = new char[count * sizeof(int) + 32 + sizeof(char *)];
+	uintptr_t addr = ((uintptr_t)(raw + sizeof(char *)) + 31) & ~(uintptr_t)31;
+	((char **)addr)[-1] = raw;
+	memset((void *)addr, 0, count * sizeof(int));
+	return (int *)addr;
+}
+
+static void alignedFree(int *block)
+{
+	if (block != nullptr)
+		delete[] ((char **)block)[-1];
+}
+
+// bit k set if p[k] != 0, for 8 consecutive aligned ints
+static inline unsigned nonZeroMask8(const int *p)
+{
+#if defined(__AVX2__)
+	__m256i eq = _mm256_cmpeq_epi32(_mm256_load_si256((const __m256i *)p), _mm256_setzero_si256());
+	return ~(unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(eq)) & 0xFF;
+#elif defined(__SSE2__) || defined(_M_X64)
+	__m128i zero = _mm_setzero_si128();
+	unsigned lo = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_load_si128((const __m128i *)p), zero)));
+	unsigned hi = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_load_si128((const __m128i *)(p + 4)), zero)));
+	return ~(lo | (hi << 4)) & 0xFF;
+#else
+	unsigned mask = 0;
+	for (int k = 0; k < 8; k++)
+		if (p[k] != 0)
+			mask |= 1u << k;
+	return mask;
+#endif
+}
+
+// index of the lowest set bit, mask != 0
+static inline int lowestBit(unsigned mask)
 {
-	m_Mat = new int *[size];
-	for (int i = 0; i < size; i++)
+#if defined(__GNUC__)
+	return __builtin_ctz(mask);
+#else
+	int k = 0;
+	while (!(mask & 1u))
 	{
-		m_Mat[i] = new int[size];
-		for (int j = 0; j < size; j++)
-		{
-			m_Mat[i][j] = 0;
-		}
+		mask >>= 1;
+		k++;
 	}
+	return k;
+#endif
+}
+
+// Constructor - Graph Initialization
+MatrixGraph::MatrixGraph(bool type, int size) : Graph(type, size)
+{
+	m_Stride = size > 0 ? (size + 7) & ~7 : 0;
+	m_Mat = alignedAlloc((size_t)m_Stride * m_Stride);
+	m_Trans = alignedAlloc((size_t)m_Stride * m_Stride);
 }
 
 // destructor
 MatrixGraph::~MatrixGraph()
 {
-	if (m_Mat != nullptr)
-	{
-		for (int i = 0; i < m_Size; i++)
-		{
-			delete[] m_Mat[i];
-		}
-		delete[] m_Mat;
-	}
+	alignedFree(m_Mat);
+	alignedFree(m_Trans);
+}
+
+// multimap inserter used by the legacy adjacency functions
+static bool insertNeighbor(void *context, int neighbor, int weight)
+{
+	((multimap<int, int> *)context)->insert(make_pair(neighbor, weight));
+	return true;
 }
 
 // undirected perspective
 void MatrixGraph::getAdjacentEdges(int vertex, multimap<int, int> *m)
 {
-	if (vertex < 0 || vertex >= m_Size)
-		return;
-
-	for (int i = 0; i < m_Size; i++)
-	{
-		// row, in-degree
-		if (m_Mat[vertex][i] != 0)
-		{
-			m->insert(make_pair(i, m_Mat[vertex][i]));
-		}
-		// column, out-degree
-		if (m_Mat[i][vertex] != 0)
-		{
-			m->insert(make_pair(i, m_Mat[i][vertex]));
-		}
-	}
+	visitEdges(vertex, EDGE_BOTH, insertNeighbor, m);
 }
 // Directed perspective
 void MatrixGraph::getAdjacentEdgesDirect(int vertex, multimap<int, int>* m)
+{
+	visitEdges(vertex, EDGE_OUT, insertNeighbor, m);
+}
+// Insert edge, the transpose is kept in sync
+void MatrixGraph::insertEdge(int from, int to, int weight)
+{
+	if (from >= 0 && from < m_Size && to >= 0 && to < m_Size)
+	{
+		int &slot = m_Mat[(size_t)from * m_Stride + to];
+		// count edges appearing / disappearing
+		if (slot == 0 && weight != 0)
+			m_EdgeCount++;
+		else if (slot != 0 && weight == 0)
+			m_EdgeCount--;
+		slot = weight;
+		m_Trans[(size_t)to * m_Stride + from] = weight;
+	}
+}
+
+// Delete edge, the slot goes back to 0
+int MatrixGraph::deleteEdge(int from, int to)
+{
+	if (from < 0 || from >= m_Size || to < 0 || to >= m_Size || m_Mat[(size_t)from * m_Stride + to] == 0)
+		return 0;
+	insertEdge(from, to, 0);
+	return 1;
+}
+
+// Change the weight of an existing edge, weight 0 deletes it
+int MatrixGraph::updateWeight(int from, int to, int weight)
+{
+	if (from < 0 || from >= m_Size || to < 0 || to >= m_Size || m_Mat[(size_t)from * m_Stride + to] == 0)
+		return 0;
+	insertEdge(from, to, weight);
+	return 1;
+}
+
+// visit edges without building a multimap, ascending neighbor order
+// row (out-degree) and transposed row (in-degree) are scanned 8 ints at a time
+void MatrixGraph::visitEdges(int vertex, EdgeDirection dir, EdgeVisitor visit, void *context)
 {
 	if (vertex < 0 || vertex >= m_Size)
 		return;
 
-	for (int i = 0; i < m_Size; i++)
+	const int *row = m_Mat + (size_t)vertex * m_Stride;
+	const int *col = m_Trans + (size_t)vertex * m_Stride;
+	for (int j = 0; j < m_Stride; j += 8)
 	{
-		if (m_Mat[vertex][i] != 0)
+		unsigned rowMask = dir != EDGE_IN ? nonZeroMask8(row + j) : 0;
+		unsigned colMask = dir != EDGE_OUT ? nonZeroMask8(col + j) : 0;
+		unsigned mask = rowMask | colMask;
+		// emit only the nonzero lanes, row before column for the same neighbor
+		while (mask != 0)
 		{
-			m->insert(make_pair(i, m_Mat[vertex][i]));
+			int k = lowestBit(mask);
+			mask &= mask - 1;
+			if ((rowMask & (1u << k)) && !visit(context, j + k, row[j + k]))
+				return;
+			if ((colMask & (1u << k)) && !visit(context, j + k, col[j + k]))
+				return;
 		}
 	}
 }
-// Insert edge
-void MatrixGraph::insertEdge(int from, int to, int weight)
-{
-	if (from >= 0 && from < m_Size && to >= 0 && to < m_Size)
-	{
-		m_Mat[from][to] = weight;
-	}
-}
 
 // print graph, matrix perspective
-bool MatrixGraph::printGraph(ofstream *fout)
+bool MatrixGraph::printGraph(ostream *fout)
 {
 	if (m_Size < 0)
 		return false;
 
 	*fout << "========PRINT========" << endl;
 
-	*fout << "\t";
-	for (int i = 0; i < m_Size; i++)
-	{
-		*fout << "[" << i << "]" << "\t";
-	}
-	*fout << endl;
+	TextBuffer header;
+	formatMatrixHeader(header, m_Size);
+	fout->write(header.data(), header.size());
 
-	// output matrix format
-	for (int i = 0; i < m_Size; i++)
+	// output matrix format, rows formatted in parallel blocks
+	writeRows(*fout, m_Size, [&](int i, TextBuffer &text)
 	{
-		*fout << "[" << i << "]" << "\t"; // row number
+		const int *row = getRow(i);
+		text.putLabel(i); // row number
+		text.put('\t');
 		for (int j = 0; j < m_Size; j++)
 		{
-			*fout << m_Mat[i][j] << "\t";
+			text.putInt(row[j]);
+			text.put('\t');
 		}
-		*fout << endl;
-	}
+		text.put('\n');
+	});
 	*fout << "=====================\n\n";
 	return true;
-}
\ No newline at end of file
+}
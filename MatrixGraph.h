@@ -6,7 +6,10 @@
 class MatrixGraph : public Graph
 {
 private:
-	int **m_Mat;
+	// single 32-byte aligned row-major block, rows padded with zeros to m_Stride
+	int *m_Mat;
+	int *m_Trans; // transpose of m_Mat, columns become contiguous rows
+	int m_Stride; // ints per row, multiple of 8
 
 public:
 	MatrixGraph(bool type, int size);
@@ -15,7 +18,14 @@ public:
 	void getAdjacentEdges(int vertex, multimap<int, int> *m);
 	void getAdjacentEdgesDirect(int vertex, multimap<int, int> *m);
 	void insertEdge(int from, int to, int weight);
-	bool printGraph(ofstream *fout);
+	int deleteEdge(int from, int to);
+	int updateWeight(int from, int to, int weight);
+	bool printGraph(ostream *fout);
+	void visitEdges(int vertex, EdgeDirection dir, EdgeVisitor visit, void *context);
+
+	// raw access for algorithms scanning whole rows, 0 means no edge
+	const int *getRow(int vertex) { return m_Mat + (size_t)vertex * m_Stride; }	  // out-edges of vertex
+	const int *getColumn(int vertex) { return m_Trans + (size_t)vertex * m_Stride; } // in-edges of vertex
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,54 @@
+#ifndef _PARALLEL_H_
+#define _PARALLEL_H_
+
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <cstdlib>
+
+// Number of worker threads used by the parallel algorithms
+// DS_THREADS environment variable overrides the hardware thread count
+inline int workerCount()
+{
+	static int count = 0;
+	if (count == 0)
+	{
+		const char *env = getenv("DS_THREADS");
+		int n = env != nullptr ? atoi(env) : (int)std::thread::hardware_concurrency();
+		count = n > 0 ? n : 1;
+	}
+	return count;
+}
+
+// Runs body(index, worker) for every index in [begin, end)
+// indices are handed out dynamically, worker is in [0, workerCount())
+template <class F>
+void parallelFor(int begin, int end, F body)
+{
+	int workers = workerCount();
+	if (end - begin < workers)
+		workers = end - begin;
+	// small ranges run on the calling thread
+	if (workers <= 1)
+	{
+		for (int i = begin; i < end; i++)
+			body(i, 0);
+		return;
+	}
+
+	std::atomic<int> next(begin);
+	auto work = [&](int worker)
+	{
+		for (int i = next++; i < end; i = next++)
+			body(i, worker);
+	};
+
+	std::vector<std::thread> threads;
+	for (int w = 1; w < workers; w++)
+		threads.push_back(std::thread(work, w));
+	work(0);
+	for (size_t t = 0; t < threads.size(); t++)
+		threads[t].join();
+}
+
+#endif
@@ -0,0 +1,332 @@
+#include "ParallelBFS.h"
+#include "Parallel.h"
+
+typedef unsigned long long Word;
+
+// index of the lowest set bit, bits != 0
+static inline int lowestBit(Word bits)
+{
+#if defined(__GNUC__)
+	return __builtin_ctzll(bits);
+#else
+	int k = 0;
+	while (!(bits & 1ull))
+	{
+		bits >>= 1;
+		k++;
+	}
+	return k;
+#endif
+}
+
+// bitmap of size bits with atomic set
+class AtomicBitmap
+{
+private:
+	vector<atomic<Word>> m_Words;
+
+public:
+	AtomicBitmap(int size) : m_Words((size + 63) / 64)
+	{
+		clear();
+	}
+
+	void clear()
+	{
+		for (size_t i = 0; i < m_Words.size(); i++)
+			m_Words[i].store(0, memory_order_relaxed);
+	}
+	bool test(int v) { return (m_Words[v >> 6].load(memory_order_relaxed) >> (v & 63)) & 1; }
+	// true if this call set the bit
+	bool set(int v)
+	{
+		Word bit = (Word)1 << (v & 63);
+		return !(m_Words[v >> 6].fetch_or(bit, memory_order_relaxed) & bit);
+	}
+};
+
+void bfsLevels(Graph *graph, char option, int source, vector<int> &level)
+{
+	int size = graph->getSize();
+	EdgeDirection forward = option == 'O' ? EDGE_OUT : EDGE_BOTH;
+	EdgeDirection backward = option == 'O' ? EDGE_IN : EDGE_BOTH;
+	int workers = workerCount();
+
+	level.assign(size, -1);
+	level[source] = 0;
+
+	// out-degree of every vertex for the switching heuristic
+	vector<int> degree(size, 0);
+	parallelFor(0, size, [&](int v, int)
+	{
+		graph->forEachEdge(v, forward, [&](int, int)
+		{
+			degree[v]++;
+		});
+	});
+	long long unexplored = 0;
+	for (int v = 0; v < size; v++)
+		unexplored += degree[v];
+
+	AtomicBitmap visited(size), current(size), next(size);
+	visited.set(source);
+	current.set(source);
+	vector<int> frontier(1, source);
+	vector<vector<int>> found(workers); // next frontier pieces, one per worker
+	bool bottomUp = false;
+
+	for (int depth = 0; !frontier.empty(); depth++)
+	{
+		long long frontierEdges = 0;
+		for (size_t i = 0; i < frontier.size(); i++)
+			frontierEdges += degree[frontier[i]];
+		unexplored -= frontierEdges;
+
+		// direction switch
+		if (!bottomUp && frontierEdges > unexplored / BFS_ALPHA)
+			bottomUp = true;
+		else if (bottomUp && (long long)frontier.size() * BFS_BETA < size)
+			bottomUp = false;
+
+		if (bottomUp)
+		{
+			// every unvisited vertex looks for a parent in the frontier, 64 vertices per task
+			next.clear();
+			parallelFor(0, (size + 63) / 64, [&](int block, int worker)
+			{
+				int end = min(size, (block + 1) * 64);
+				for (int v = block * 64; v < end; v++)
+				{
+					if (visited.test(v))
+						continue;
+					graph->forEachEdgeUntil(v, backward, [&](int u, int) -> bool
+					{
+						if (!current.test(u))
+							return true;
+						level[v] = depth + 1;
+						visited.set(v);
+						next.set(v);
+						found[worker].push_back(v);
+						return false; // one parent is enough
+					});
+				}
+			});
+			swap(current, next);
+		}
+		else
+		{
+			// frontier vertices claim their unvisited neighbors
+			parallelFor(0, (int)frontier.size(), [&](int i, int worker)
+			{
+				graph->forEachEdge(frontier[i], forward, [&](int v, int)
+				{
+					if (!visited.test(v) && visited.set(v))
+					{
+						level[v] = depth + 1;
+						found[worker].push_back(v);
+					}
+				});
+			});
+			current.clear();
+			for (int w = 0; w < workers; w++)
+			{
+				for (size_t i = 0; i < found[w].size(); i++)
+					current.set(found[w][i]);
+			}
+		}
+
+		frontier.clear();
+		for (int w = 0; w < workers; w++)
+		{
+			frontier.insert(frontier.end(), found[w].begin(), found[w].end());
+			found[w].clear();
+		}
+	}
+}
+
+void bfsOrder(Graph *graph, char option, int source, const vector<int> &level, vector<int> &order)
+{
+	int size = graph->getSize();
+	EdgeDirection backward = option == 'O' ? EDGE_IN : EDGE_BOTH;
+
+	// bucket vertices by level
+	int depth = 0;
+	for (int v = 0; v < size; v++)
+		depth = max(depth, level[v]);
+	vector<int> start(depth + 2, 0);
+	for (int v = 0; v < size; v++)
+	{
+		if (level[v] >= 0)
+			start[level[v] + 1]++;
+	}
+	for (int d = 0; d <= depth; d++)
+		start[d + 1] += start[d];
+	order.assign(start[depth + 1], -1);
+	vector<int> fill(start.begin(), start.end() - 1);
+	for (int v = 0; v < size; v++)
+	{
+		if (level[v] >= 0)
+			order[fill[level[v]]++] = v;
+	}
+
+	vector<int> position(size, INF); // index in the final order
+	position[source] = 0;
+	vector<pair<int, int>> keyed;
+	for (int d = 1; d <= depth; d++)
+	{
+		// key = position of the earliest parent on the previous level
+		int first = start[d], count = start[d + 1] - start[d];
+		keyed.resize(count);
+		parallelFor(0, count, [&](int i, int)
+		{
+			int v = order[first + i];
+			int key = INF;
+			graph->forEachEdge(v, backward, [&](int u, int)
+			{
+				if (level[u] == d - 1 && position[u] < key)
+					key = position[u];
+			});
+			keyed[i] = make_pair(key, v);
+		});
+		sort(keyed.begin(), keyed.end());
+		for (int i = 0; i < count; i++)
+		{
+			order[first + i] = keyed[i].second;
+			position[keyed[i].second] = first + i;
+		}
+	}
+}
+
+void multiSourceBFS(Graph *graph, char option, const vector<int> &sources, vector<vector<int>> &level)
+{
+	int size = graph->getSize();
+	int count = (int)sources.size();
+	int words = (count + 63) / 64; // mask words per vertex
+	EdgeDirection forward = option == 'O' ? EDGE_OUT : EDGE_BOTH;
+	EdgeDirection backward = option == 'O' ? EDGE_IN : EDGE_BOTH;
+	int workers = workerCount();
+
+	level.assign(count, vector<int>(size, -1));
+	if (count == 0)
+		return;
+	// seen : sources that reached the vertex, visit : sources reaching it on the current level
+	vector<Word> seen((size_t)size * words, 0), visit((size_t)size * words, 0), next((size_t)size * words, 0);
+	vector<Word> full(words, ~(Word)0); // mask with every source of the batch
+	if (count % 64 != 0)
+		full[words - 1] = ((Word)1 << (count % 64)) - 1;
+
+	vector<int> frontier;
+	for (int i = 0; i < count; i++)
+	{
+		int s = sources[i];
+		Word bit = (Word)1 << (i & 63);
+		bool fresh = true; // the same vertex may be listed more than once
+		for (int w = 0; w < words; w++)
+			fresh = fresh && visit[(size_t)s * words + w] == 0;
+		if (fresh)
+			frontier.push_back(s);
+		seen[(size_t)s * words + (i >> 6)] |= bit;
+		visit[(size_t)s * words + (i >> 6)] |= bit;
+		level[i][s] = 0;
+	}
+
+	vector<vector<int>> found(workers); // next frontier pieces, one per worker
+	vector<int> touched;
+	for (int depth = 0; !frontier.empty(); depth++)
+	{
+		if ((long long)frontier.size() * BFS_BETA < size)
+		{
+			// small frontier : push the masks along out-edges
+			for (size_t i = 0; i < frontier.size(); i++)
+			{
+				const Word *from = &visit[(size_t)frontier[i] * words];
+				graph->forEachEdge(frontier[i], forward, [&](int v, int)
+				{
+					Word *to = &next[(size_t)v * words];
+					bool fresh = true;
+					for (int w = 0; w < words; w++)
+					{
+						fresh = fresh && to[w] == 0;
+						to[w] |= from[w];
+					}
+					if (fresh)
+						touched.push_back(v);
+				});
+			}
+			for (size_t i = 0; i < touched.size(); i++)
+			{
+				int v = touched[i];
+				Word *to = &next[(size_t)v * words];
+				Word *mask = &seen[(size_t)v * words];
+				bool any = false;
+				for (int w = 0; w < words; w++)
+				{
+					to[w] &= ~mask[w];
+					mask[w] |= to[w];
+					any = any || to[w] != 0;
+				}
+				if (any)
+					found[0].push_back(v);
+			}
+			touched.clear();
+		}
+		else
+		{
+			// large frontier : every vertex pulls the masks of its in-neighbors
+			parallelFor(0, size, [&](int v, int worker)
+			{
+				Word *to = &next[(size_t)v * words];
+				Word *mask = &seen[(size_t)v * words];
+				bool done = true;
+				for (int w = 0; w < words; w++)
+					done = done && mask[w] == full[w];
+				if (done)
+					return;
+				graph->forEachEdgeUntil(v, backward, [&](int u, int) -> bool
+				{
+					const Word *from = &visit[(size_t)u * words];
+					bool covered = true;
+					for (int w = 0; w < words; w++)
+					{
+						to[w] |= from[w];
+						covered = covered && (to[w] | mask[w]) == full[w];
+					}
+					return !covered; // every missing source arrived
+				});
+				bool any = false;
+				for (int w = 0; w < words; w++)
+				{
+					to[w] &= ~mask[w];
+					mask[w] |= to[w];
+					any = any || to[w] != 0;
+				}
+				if (any)
+					found[worker].push_back(v);
+			});
+		}
+
+		// record the new level, old masks are cleared so next starts empty
+		for (size_t i = 0; i < frontier.size(); i++)
+		{
+			for (int w = 0; w < words; w++)
+				visit[(size_t)frontier[i] * words + w] = 0;
+		}
+		frontier.clear();
+		for (int t = 0; t < workers; t++)
+		{
+			frontier.insert(frontier.end(), found[t].begin(), found[t].end());
+			found[t].clear();
+		}
+		parallelFor(0, (int)frontier.size(), [&](int i, int)
+		{
+			int v = frontier[i];
+			const Word *mask = &next[(size_t)v * words];
+			for (int w = 0; w < words; w++)
+			{
+				for (Word bits = mask[w]; bits != 0; bits &= bits - 1)
+					level[w * 64 + lowestBit(bits)][v] = depth + 1;
+			}
+		});
+		swap(visit, next);
+	}
+}
@@ -0,0 +1,28 @@
+#ifndef _PARALLELBFS_H_
+#define _PARALLELBFS_H_
+
+#include "Graph.h"
+
+// Beamer's switching thresholds : bottom-up once frontier edges > unexplored edges / ALPHA,
+// back to top-down once the frontier holds fewer than V / BETA vertices
+const int BFS_ALPHA = 14;
+const int BFS_BETA = 24;
+
+// Hop level of every vertex from source (-1 if unreachable)
+// level synchronous, direction-optimizing (top-down / bottom-up), parallel over the frontier
+// option 'O' directed, otherwise undirected
+void bfsLevels(Graph *graph, char option, int source, vector<int> &level);
+
+// Visiting order of the sequential queue BFS rebuilt from the levels : inside a level,
+// vertices come ordered by the position of their first parent, then ascending
+void bfsOrder(Graph *graph, char option, int source, const vector<int> &level, vector<int> &order);
+
+// Sources traversed together by one multi-source BFS pass (one bit per source)
+const int MSBFS_BATCH = 256;
+
+// Hop levels from up to MSBFS_BATCH sources at once, level[i] belongs to sources[i]
+// every vertex carries a bitmask of the sources that reached it, so one adjacency scan
+// advances all of them
+void multiSourceBFS(Graph *graph, char option, const vector<int> &sources, vector<vector<int>> &level);
+
+#endif
@@ -0,0 +1,128 @@
+#include "PointToPoint.h"
+
+PointToPoint::PointToPoint(Graph *graph, ComponentIndex *components) : m_Forward(graph->getSize()), m_Backward(graph->getSize())
+{
+	m_Graph = graph;
+	m_Components = components;
+	for (int side = 0; side < 2; side++)
+	{
+		m_Dist[side].assign(graph->getSize(), INF);
+		m_Parent[side].assign(graph->getSize(), -1);
+		m_HasRange[side] = false;
+	}
+}
+
+// forget the previous query, O(touched vertices)
+void PointToPoint::reset()
+{
+	for (size_t i = 0; i < m_Touched.size(); i++)
+	{
+		int v = m_Touched[i];
+		m_Dist[0][v] = m_Dist[1][v] = INF;
+		m_Parent[0][v] = m_Parent[1][v] = -1;
+	}
+	m_Touched.clear();
+	m_Forward.clear();
+	m_Backward.clear();
+}
+
+void PointToPoint::touch(int side, int v, int dist, int parent)
+{
+	if (m_Dist[0][v] == INF && m_Dist[1][v] == INF)
+		m_Touched.push_back(v);
+	m_Dist[side][v] = dist;
+	m_Parent[side][v] = parent;
+}
+
+bool PointToPoint::query(char option, int s, int t, int &cost, vector<int> &path, bool &bidirectional)
+{
+	int o = option == 'O' ? 0 : 1;
+	if (!m_HasRange[o])
+	{
+		m_Range[o] = scanWeights(m_Graph, option);
+		m_HasRange[o] = true;
+	}
+	path.clear();
+
+	// negative weights : single source Bellman-Ford
+	if (m_Range[o].hasEdge && m_Range[o].minWeight < 0)
+	{
+		bidirectional = false;
+		if (m_Components != nullptr)
+		{
+			if (option != 'O' && m_Components->hasNegative(s))
+				return false; // an undirected negative edge is a negative cycle
+			if (m_Components->negativeCycleFree(option, s) && m_Components->unreachable(option, s, t))
+			{
+				cost = INF;
+				return true;
+			}
+		}
+		vector<int> dist, parent;
+		if (!bellmanFordTree(m_Graph, option, s, dist, parent))
+			return false;
+		cost = dist[t];
+		for (int v = t; cost != INF && v != -1; v = parent[v])
+			path.push_back(v);
+		reverse(path.begin(), path.end());
+		return true;
+	}
+
+	bidirectional = true;
+	if (m_Components != nullptr && m_Components->unreachable(option, s, t))
+	{
+		cost = INF; // different components, no search
+		return true;
+	}
+	reset();
+	EdgeDirection dir[2];
+	dir[0] = option == 'O' ? EDGE_OUT : EDGE_BOTH;
+	dir[1] = option == 'O' ? EDGE_IN : EDGE_BOTH;
+	IndexedHeap *heap[2] = {&m_Forward, &m_Backward};
+
+	touch(0, s, 0, -1);
+	touch(1, t, 0, -1);
+	m_Forward.push(s, 0);
+	m_Backward.push(t, 0);
+
+	int best = s == t ? 0 : INF; // shortest s -> t length seen so far
+	int meet = s == t ? s : -1;
+
+	// stop once no unsettled pair of frontier vertices can beat best
+	while (!m_Forward.empty() && !m_Backward.empty())
+	{
+		if (m_Forward.topKey() + m_Backward.topKey() >= best)
+			break;
+
+		// grow the side with the closer frontier
+		int side = m_Forward.topKey() <= m_Backward.topKey() ? 0 : 1;
+		int u = heap[side]->pop();
+		int du = m_Dist[side][u];
+
+		m_Graph->forEachEdge(u, dir[side], [&](int v, int w)
+		{
+			if (m_Dist[side][v] <= du + w)
+				return;
+			touch(side, v, du + w, u);
+			heap[side]->push(v, du + w);
+			// v already reached from the other side : candidate path
+			if (m_Dist[1 - side][v] != INF && m_Dist[0][v] + m_Dist[1][v] < best)
+			{
+				best = m_Dist[0][v] + m_Dist[1][v];
+				meet = v;
+			}
+		});
+	}
+
+	cost = best;
+	if (best == INF)
+		return true;
+
+	// s ... meet from the forward tree, meet ... t from the backward tree
+	for (int v = meet; v != -1; v = m_Parent[0][v])
+		path.push_back(v);
+	reverse(path.begin(), path.end());
+	for (int v = m_Parent[1][meet]; v != -1; v = m_Parent[1][v])
+		path.push_back(v);
+	return true;
+}
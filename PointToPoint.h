@@ -0,0 +1,40 @@
+#ifndef _POINTTOPOINT_H_
+#define _POINTTOPOINT_H_
+
+#include "Graph.h"
+#include "PriorityQueue.h"
+#include "SSSP.h"
+#include "Components.h"
+
+// s -> t shortest path queries on one loaded graph
+// bidirectional Dijkstra (forward on out-edges, backward on in-edges) stopping when the
+// frontiers meet, Bellman-Ford when the graph has negative weights
+// the work arrays are reused, a query only resets the vertices it touched
+class PointToPoint
+{
+private:
+	Graph *m_Graph;
+	ComponentIndex *m_Components; // answers disconnected pairs without a search, may be nullptr
+	vector<int> m_Dist[2];   // [0] from s, [1] to t
+	vector<int> m_Parent[2]; // [0] previous vertex toward s, [1] next vertex toward t
+	IndexedHeap m_Forward;
+	IndexedHeap m_Backward;
+	vector<int> m_Touched;     // vertices with a finite distance on either side
+	bool m_HasRange[2];        // weight range cached per option ([0] 'O', [1] otherwise)
+	WeightRange m_Range[2];
+
+	void reset();
+	void touch(int side, int v, int dist, int parent);
+
+public:
+	PointToPoint(Graph *graph, ComponentIndex *components = nullptr);
+
+	int getSize() { return m_Graph->getSize(); }
+
+	// cost = INF if t is unreachable, path from s to t otherwise
+	// bidirectional = false when Bellman-Ford answered the query
+	// returns false if a negative cycle is reachable from s
+	bool query(char option, int s, int t, int &cost, vector<int> &path, bool &bidirectional);
+};
+
+#endif
@@ -0,0 +1,235 @@
+#include "PriorityQueue.h"
+
+// ---------------- IndexedHeap ----------------
+
+IndexedHeap::IndexedHeap(int size)
+{
+	m_Key.assign(size, INF);
+	m_Pos.assign(size, -1);
+}
+
+// (key, vertex) order, same tie breaking as a priority_queue of pairs
+bool IndexedHeap::less(int a, int b)
+{
+	if (m_Key[a] != m_Key[b])
+		return m_Key[a] < m_Key[b];
+	return a < b;
+}
+
+void IndexedHeap::siftUp(int i)
+{
+	int v = m_Heap[i];
+	while (i > 0)
+	{
+		int parent = (i - 1) / ARITY;
+		if (!less(v, m_Heap[parent]))
+			break;
+		m_Heap[i] = m_Heap[parent];
+		m_Pos[m_Heap[i]] = i;
+		i = parent;
+	}
+	m_Heap[i] = v;
+	m_Pos[v] = i;
+}
+
+void IndexedHeap::siftDown(int i)
+{
+	int v = m_Heap[i];
+	int n = (int)m_Heap.size();
+	while (true)
+	{
+		// smallest child among the ARITY children
+		int first = i * ARITY + 1;
+		if (first >= n)
+			break;
+		int best = first;
+		for (int c = first + 1; c < first + ARITY && c < n; c++)
+		{
+			if (less(m_Heap[c], m_Heap[best]))
+				best = c;
+		}
+		if (!less(m_Heap[best], v))
+			break;
+		m_Heap[i] = m_Heap[best];
+		m_Pos[m_Heap[i]] = i;
+		i = best;
+	}
+	m_Heap[i] = v;
+	m_Pos[v] = i;
+}
+
+void IndexedHeap::push(int v, int key)
+{
+	if (m_Pos[v] == -1)
+	{
+		m_Key[v] = key;
+		m_Heap.push_back(v);
+		siftUp((int)m_Heap.size() - 1);
+	}
+	else if (key < m_Key[v])
+	{
+		// decrease-key
+		m_Key[v] = key;
+		siftUp(m_Pos[v]);
+	}
+}
+
+int IndexedHeap::pop()
+{
+	int top = m_Heap[0];
+	m_Pos[top] = -1;
+	int last = m_Heap.back();
+	m_Heap.pop_back();
+	if (!m_Heap.empty())
+	{
+		m_Heap[0] = last;
+		siftDown(0);
+	}
+	return top;
+}
+
+// empty the heap for reuse, O(queued vertices)
+void IndexedHeap::clear()
+{
+	for (size_t i = 0; i < m_Heap.size(); i++)
+		m_Pos[m_Heap[i]] = -1;
+	m_Heap.clear();
+}
+
+// ---------------- BucketArray ----------------
+
+BucketArray::BucketArray(int buckets, int size)
+{
+	m_Buckets.resize(buckets);
+	m_BucketOf.assign(size, -1);
+	m_Slot.assign(size, -1);
+}
+
+void BucketArray::insert(int b, int v)
+{
+	m_BucketOf[v] = b;
+	m_Slot[v] = (int)m_Buckets[b].size();
+	m_Buckets[b].push_back(v);
+}
+
+// swap with the last vertex of the bucket, O(1)
+void BucketArray::remove(int v)
+{
+	vector<int> &items = m_Buckets[m_BucketOf[v]];
+	int moved = items.back();
+	items[m_Slot[v]] = moved;
+	m_Slot[moved] = m_Slot[v];
+	items.pop_back();
+	m_BucketOf[v] = -1;
+}
+
+int BucketArray::popBack(int b)
+{
+	int v = m_Buckets[b].back();
+	m_Buckets[b].pop_back();
+	m_BucketOf[v] = -1;
+	return v;
+}
+
+// ---------------- RadixHeap ----------------
+
+RadixHeap::RadixHeap(int size) : m_Buckets(33, size)
+{
+	m_Key.assign(size, INF);
+	m_Last = 0;
+	m_Count = 0;
+}
+
+// bucket 0 holds keys equal to m_Last, bucket b the keys whose highest bit differing from m_Last is b - 1
+int RadixHeap::bucketIndex(unsigned key)
+{
+	unsigned diff = key ^ m_Last;
+	if (diff == 0)
+		return 0;
+#if defined(__GNUC__)
+	return 32 - __builtin_clz(diff);
+#else
+	int b = 0;
+	while (diff != 0)
+	{
+		diff >>= 1;
+		b++;
+	}
+	return b;
+#endif
+}
+
+void RadixHeap::push(int v, int key)
+{
+	if (m_Buckets.contains(v))
+	{
+		if (key >= m_Key[v])
+			return;
+		m_Buckets.remove(v); // decrease-key : move to its new bucket
+	}
+	else
+		m_Count++;
+	m_Key[v] = key;
+	m_Buckets.insert(bucketIndex((unsigned)key), v);
+}
+
+int RadixHeap::pop()
+{
+	if (m_Buckets.emptyBucket(0))
+	{
+		// first non-empty bucket, its minimum becomes the new m_Last
+		int b = 1;
+		while (m_Buckets.emptyBucket(b))
+			b++;
+		vector<int> &items = m_Buckets.bucket(b);
+		unsigned smallest = (unsigned)m_Key[items[0]];
+		for (size_t i = 1; i < items.size(); i++)
+		{
+			if ((unsigned)m_Key[items[i]] < smallest)
+				smallest = (unsigned)m_Key[items[i]];
+		}
+		m_Last = smallest;
+
+		// redistribute, every vertex lands in a lower bucket
+		while (!items.empty())
+		{
+			int v = m_Buckets.popBack(b);
+			m_Buckets.insert(bucketIndex((unsigned)m_Key[v]), v);
+		}
+	}
+	m_Count--;
+	return m_Buckets.popBack(0);
+}
+
+// ---------------- DialQueue ----------------
+
+DialQueue::DialQueue(int size, int maxWeight) : m_Buckets(maxWeight + 1, size)
+{
+	m_Key.assign(size, INF);
+	m_Width = maxWeight + 1;
+	m_Cursor = 0;
+	m_Count = 0;
+}
+
+void DialQueue::push(int v, int key)
+{
+	if (m_Buckets.contains(v))
+	{
+		if (key >= m_Key[v])
+			return;
+		m_Buckets.remove(v); // decrease-key : move to its new bucket
+	}
+	else
+		m_Count++;
+	m_Key[v] = key;
+	m_Buckets.insert(key % m_Width, v);
+}
+
+int DialQueue::pop()
+{
+	// advance to the next non-empty bucket
+	while (m_Buckets.emptyBucket(m_Cursor % m_Width))
+		m_Cursor++;
+	m_Count--;
+	return m_Buckets.popBack(m_Cursor % m_Width);
+}
@@ -0,0 +1,93 @@
+#ifndef _PRIORITYQUEUE_H_
+#define _PRIORITYQUEUE_H_
+
+#include "Graph.h"
+
+// Min-priority queues over vertices [0, size) for the shortest path code
+// Every queue holds a vertex at most once (O(V) memory), push() inserts or decreases its key
+//   empty()      : no vertex left
+//   push(v, key) : insert v, or lower the key of v if already queued
+//   pop()        : remove and return a vertex with the smallest key
+
+// Indexed d-ary heap ordered by (key, vertex), real decrease-key
+class IndexedHeap
+{
+private:
+	static const int ARITY = 4;
+	vector<int> m_Heap; // vertices in heap order
+	vector<int> m_Key;  // key of every queued vertex
+	vector<int> m_Pos;  // position in m_Heap, -1 if not queued
+
+	bool less(int a, int b);
+	void siftUp(int i);
+	void siftDown(int i);
+
+public:
+	IndexedHeap(int size);
+
+	bool empty() { return m_Heap.empty(); }
+	int topKey() { return m_Key[m_Heap[0]]; }
+	void push(int v, int key);
+	int pop();
+	void clear();
+};
+
+// Buckets of vertices with O(1) insert / remove of a given vertex
+class BucketArray
+{
+private:
+	vector<vector<int>> m_Buckets;
+	vector<int> m_BucketOf; // bucket of every vertex, -1 if absent
+	vector<int> m_Slot;     // index inside its bucket
+
+public:
+	BucketArray(int buckets, int size);
+
+	bool contains(int v) { return m_BucketOf[v] != -1; }
+	bool emptyBucket(int b) { return m_Buckets[b].empty(); }
+	vector<int> &bucket(int b) { return m_Buckets[b]; }
+	void insert(int b, int v);
+	void remove(int v);
+	int popBack(int b);
+};
+
+// Monotone radix heap for non-negative integer keys
+// keys pushed must not be below the last popped key (true for Dijkstra)
+class RadixHeap
+{
+private:
+	BucketArray m_Buckets;
+	vector<int> m_Key;
+	unsigned m_Last; // last popped key
+	int m_Count;
+
+	int bucketIndex(unsigned key);
+
+public:
+	RadixHeap(int size);
+
+	bool empty() { return m_Count == 0; }
+	void push(int v, int key);
+	int pop();
+};
+
+// Dial's circular buckets, for non-negative keys when the largest edge weight is small
+// queued keys always lie within [current minimum, current minimum + maxWeight]
+class DialQueue
+{
+private:
+	BucketArray m_Buckets;
+	vector<int> m_Key;
+	int m_Width;  // maxWeight + 1 buckets
+	int m_Cursor; // smallest key that may still be queued
+	int m_Count;
+
+public:
+	DialQueue(int size, int maxWeight);
+
+	bool empty() { return m_Count == 0; }
+	void push(int v, int key);
+	int pop();
+};
+
+#endif
@@ -0,0 +1,100 @@
+#include "ResultExport.h"
+
+// values are copied byte-swapped through this many bytes at a time on a big-endian host
+static const size_t SWAP_CHUNK = 1 << 16;
+
+static bool littleEndian()
+{
+	uint16_t probe = 1;
+	return *(const unsigned char *)&probe == 1;
+}
+
+ResultWriter::ResultWriter()
+{
+	m_File = nullptr;
+	m_Bytes = 0;
+	m_Failed = false;
+}
+
+ResultWriter::~ResultWriter()
+{
+	close();
+}
+
+void ResultWriter::writeRaw(const void *data, size_t bytes)
+{
+	if (m_File == nullptr || fwrite(data, 1, bytes, m_File) != bytes)
+		m_Failed = true;
+	m_Bytes += bytes;
+}
+
+template <class T>
+void ResultWriter::writeValues(const T *data, size_t count)
+{
+	if (littleEndian())
+	{
+		writeRaw(data, count * sizeof(T));
+		return;
+	}
+	// byte-swapped copies, one chunk at a time
+	vector<unsigned char> chunk;
+	for (size_t first = 0; first < count; first += SWAP_CHUNK / sizeof(T))
+	{
+		size_t n = min(count - first, SWAP_CHUNK / sizeof(T));
+		chunk.resize(n * sizeof(T));
+		const unsigned char *in = (const unsigned char *)(data + first);
+		for (size_t i = 0; i < n; i++)
+		{
+			for (size_t b = 0; b < sizeof(T); b++)
+				chunk[i * sizeof(T) + b] = in[i * sizeof(T) + sizeof(T) - 1 - b];
+		}
+		writeRaw(&chunk[0], chunk.size());
+	}
+}
+
+bool ResultWriter::open(const string &name, ResultKind kind, uint32_t flags, int vertices, int rows, int source)
+{
+	close();
+	m_Name = name;
+	m_Bytes = 0;
+	m_Failed = false;
+	m_File = fopen(name.c_str(), "wb");
+	if (m_File == nullptr)
+		return false;
+
+	// ResultHeader field by field, every field after the magic is 32-bit
+	int fields[7] = {(int)RESULT_VERSION, (int)kind, (int)flags, vertices, rows, source, INF};
+	writeRaw(RESULT_MAGIC, 4);
+	writeInts(fields, 7);
+	return !m_Failed;
+}
+
+void ResultWriter::writeInts(const int *data, size_t count)
+{
+	writeValues(data, count);
+}
+
+void ResultWriter::writeDoubles(const double *data, size_t count)
+{
+	writeValues(data, count);
+}
+
+bool ResultWriter::close()
+{
+	if (m_File == nullptr)
+		return false;
+	if (fclose(m_File) != 0)
+		m_Failed = true;
+	m_File = nullptr;
+	return !m_Failed;
+}
+
+string resultFileName(const char *command, char option, int source)
+{
+	string name = command;
+	if (option != '\0')
+		name += option == 'O' ? "_O" : "_X";
+	if (source >= 0)
+		name += "_" + to_string(source);
+	return name + ".bin";
+}
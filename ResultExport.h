@@ -0,0 +1,72 @@
+#ifndef _RESULTEXPORT_H_
+#define _RESULTEXPORT_H_
+
+#include "Graph.h"
+#include <cstdio>
+#include <string>
+#include <stdint.h>
+
+// Binary result files written by the BIN flag of FLOYD, DIJKSTRA and CENTRALITY
+// a ResultHeader, then little-endian arrays back to back, every array naturally aligned
+// so a reader can mmap the file and use the arrays in place
+//   RESULT_DISTANCES : rows x vertices int32 distances (header.infinity = unreachable)
+//                      then rows x vertices int32 parents (-1 = none) if RESULT_PARENTS is set
+//   RESULT_CLOSENESS : vertices float64 total distance to every other vertex, -1 if one is unreachable
+//                      closeness of v is (vertices - 1) / total
+const char RESULT_MAGIC[4] = {'D', 'S', 'R', 'B'};
+const uint32_t RESULT_VERSION = 1;
+
+enum ResultKind
+{
+	RESULT_DISTANCES = 1, // FLOYD (rows = vertices), DIJKSTRA (rows = 1)
+	RESULT_CLOSENESS = 2  // CENTRALITY
+};
+
+// ResultHeader::flags
+const uint32_t RESULT_DIRECTED = 1; // option 'O'
+const uint32_t RESULT_PARENTS = 2;	// parent array follows the distances
+const uint32_t RESULT_APPROX = 4;	// CENTRALITY APPROX estimate
+
+// 32 bytes, stored little-endian
+struct ResultHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t kind;
+	uint32_t flags;
+	int32_t vertices;
+	int32_t rows;
+	int32_t source;	  // DIJKSTRA start vertex, -1 otherwise
+	int32_t infinity; // distance of an unreachable vertex
+};
+
+// Writes one result file, any failed write makes close() return false
+class ResultWriter
+{
+private:
+	FILE *m_File;
+	string m_Name;
+	long long m_Bytes;
+	bool m_Failed;
+
+	void writeRaw(const void *data, size_t bytes);
+	template <class T>
+	void writeValues(const T *data, size_t count); // little-endian whatever the host order
+
+public:
+	ResultWriter();
+	~ResultWriter();
+
+	bool open(const string &name, ResultKind kind, uint32_t flags, int vertices, int rows, int source);
+	void writeInts(const int *data, size_t count);
+	void writeDoubles(const double *data, size_t count);
+	bool close();
+
+	const string &getName() { return m_Name; }
+	long long getBytes() { return m_Bytes; }
+};
+
+// "floyd_O.bin", "dijkstra_X_3.bin", "centrality.bin" : command, option and source if any
+string resultFileName(const char *command, char option, int source);
+
+#endif
@@ -0,0 +1,353 @@
+#include "SSSP.h"
+#include "PriorityQueue.h"
+#include "Parallel.h"
+
+WeightRange scanWeights(Graph *graph, char option)
+{
+	WeightRange range;
+	range.minWeight = INF;
+	range.maxWeight = -INF;
+	range.hasEdge = false;
+
+	int size = graph->getSize();
+	for (int u = 0; u < size; u++)
+	{
+		graph->forEachNeighbor(u, option, [&](int, int w)
+		{
+			if (w < range.minWeight)
+				range.minWeight = w;
+			if (w > range.maxWeight)
+				range.maxWeight = w;
+			range.hasEdge = true;
+		});
+	}
+	return range;
+}
+
+// Dijkstra main loop, shared by every queue of PriorityQueue.h
+// tieBreak : the queue does not pop equal keys in vertex order, so an equally short
+// predecessor with a smaller (dist, vertex) replaces the parent (needs weights >= 1)
+template <class Queue>
+static void runDijkstra(Graph *graph, char option, int source, Queue &pq, bool tieBreak, vector<int> &dist, vector<int> &parent)
+{
+	int size = graph->getSize();
+	dist.assign(size, INF);
+	parent.assign(size, -1);
+
+	dist[source] = 0;
+	pq.push(source, 0);
+
+	while (!pq.empty())
+	{
+		int curr = pq.pop();
+		int cost = dist[curr];
+
+		graph->forEachNeighbor(curr, option, [&](int next, int weight)
+		{
+			// Renew if the distance is shorter
+			if (dist[next] > cost + weight)
+			{
+				dist[next] = cost + weight;
+				parent[next] = curr;
+				pq.push(next, dist[next]);
+			}
+			else if (tieBreak && dist[next] == cost + weight && next != source)
+			{
+				int p = parent[next];
+				if (cost < dist[p] || (cost == dist[p] && curr < p))
+					parent[next] = curr;
+			}
+		});
+	}
+}
+
+void dijkstraTree(Graph *graph, char option, int source, const WeightRange &range, vector<int> &dist, vector<int> &parent)
+{
+	int size = graph->getSize();
+
+	// zero weights need the exact (dist, vertex) pop order of the indexed heap
+	if (!range.hasEdge || range.minWeight < 1)
+	{
+		IndexedHeap pq(size);
+		runDijkstra(graph, option, source, pq, false, dist, parent);
+	}
+	else if (range.maxWeight <= DIAL_MAX_WEIGHT)
+	{
+		DialQueue pq(size, range.maxWeight);
+		runDijkstra(graph, option, source, pq, true, dist, parent);
+	}
+	else
+	{
+		RadixHeap pq(size);
+		runDijkstra(graph, option, source, pq, true, dist, parent);
+	}
+}
+
+// dist[v] = min(dist[v], value), true if it was lowered
+static bool atomicMin(atomic<int> &target, int value)
+{
+	int current = target.load();
+	while (value < current)
+	{
+		if (target.compare_exchange_weak(current, value))
+			return true;
+	}
+	return false;
+}
+
+void deltaSteppingTree(Graph *graph, char option, int source, const WeightRange &range, vector<int> &dist, vector<int> &parent)
+{
+	if (!range.hasEdge || range.minWeight < 1)
+	{
+		dijkstraTree(graph, option, source, range, dist, parent);
+		return;
+	}
+
+	int size = graph->getSize();
+	int delta = (range.minWeight + range.maxWeight) / 2; // light edges : weight <= delta
+	int workers = workerCount();
+
+	vector<atomic<int>> best(size);
+	for (int v = 0; v < size; v++)
+		best[v].store(INF);
+	best[source].store(0);
+
+	// buckets[i] holds vertices whose tentative dist was in [i * delta, (i + 1) * delta), possibly stale
+	vector<vector<int>> buckets(1, vector<int>(1, source));
+	vector<vector<int>> requests(workers); // improved vertices found by each worker
+	vector<int> inFrontier(size, -1), inSettled(size, -1);
+	vector<int> frontier, settled;
+
+	// relax the light or heavy edges of every vertex in items, in parallel
+	auto relax = [&](const vector<int> &items, bool light)
+	{
+		parallelFor(0, (int)items.size(), [&](int k, int worker)
+		{
+			int u = items[k];
+			int du = best[u].load();
+			graph->forEachNeighbor(u, option, [&](int v, int w)
+			{
+				if ((w <= delta) == light && atomicMin(best[v], du + w))
+					requests[worker].push_back(v);
+			});
+		});
+		// move improved vertices into their bucket
+		for (int t = 0; t < workers; t++)
+		{
+			for (size_t k = 0; k < requests[t].size(); k++)
+			{
+				int v = requests[t][k];
+				size_t b = best[v].load() / delta;
+				if (b >= buckets.size())
+					buckets.resize(b + 1);
+				buckets[b].push_back(v);
+			}
+			requests[t].clear();
+		}
+	};
+
+	for (size_t i = 0; i < buckets.size(); i++)
+	{
+		settled.clear();
+		while (!buckets[i].empty())
+		{
+			// current members of bucket i, stale and duplicate entries dropped
+			frontier.clear();
+			for (size_t k = 0; k < buckets[i].size(); k++)
+			{
+				int v = buckets[i][k];
+				if ((size_t)(best[v].load() / delta) != i || inFrontier[v] == (int)i)
+					continue;
+				inFrontier[v] = (int)i;
+				frontier.push_back(v);
+				if (inSettled[v] != (int)i)
+				{
+					inSettled[v] = (int)i;
+					settled.push_back(v);
+				}
+			}
+			buckets[i].clear();
+			relax(frontier, true);
+			// a vertex lowered again inside bucket i must be scanned again
+			for (size_t k = 0; k < frontier.size(); k++)
+				inFrontier[frontier[k]] = -1;
+		}
+		// heavy edges once the bucket is final
+		relax(settled, false);
+	}
+
+	dist.resize(size);
+	for (int v = 0; v < size; v++)
+		dist[v] = best[v].load();
+
+	// parent = tight predecessor with the smallest (dist, vertex), packed into one 64-bit key
+	vector<atomic<long long>> parentKey(size);
+	for (int v = 0; v < size; v++)
+		parentKey[v].store(-1LL);
+	parallelFor(0, size, [&](int u, int)
+	{
+		if (dist[u] == INF)
+			return;
+		long long key = ((long long)dist[u] << 32) | u;
+		graph->forEachNeighbor(u, option, [&](int v, int w)
+		{
+			if (v == source || dist[u] + w != dist[v])
+				return;
+			long long current = parentKey[v].load();
+			while ((current == -1LL || key < current) && !parentKey[v].compare_exchange_weak(current, key))
+			{
+			}
+		});
+	});
+
+	parent.assign(size, -1);
+	for (int v = 0; v < size; v++)
+	{
+		if (parentKey[v].load() != -1LL)
+			parent[v] = (int)(parentKey[v].load() & 0xFFFFFFFFLL);
+	}
+}
+
+bool bellmanFordTree(Graph *graph, char option, int source, vector<int> &dist, vector<int> &parent)
+{
+	int size = graph->getSize();
+	dist.assign(size, INF);
+	parent.assign(size, -1);
+
+	vector<int> edges(size, 0); // edges on the current path to every vertex
+	vector<bool> queued(size, false);
+	queue<int> worklist;
+
+	dist[source] = 0;
+	worklist.push(source);
+	queued[source] = true;
+
+	// stops as soon as no distance changes any more
+	while (!worklist.empty())
+	{
+		int u = worklist.front();
+		worklist.pop();
+		queued[u] = false;
+
+		bool cycle = false;
+		graph->forEachNeighbor(u, option, [&](int v, int w)
+		{
+			if (cycle || dist[v] <= dist[u] + w)
+				return;
+			dist[v] = dist[u] + w;
+			parent[v] = u;
+			edges[v] = edges[u] + 1;
+			// a shortest path never needs V edges, otherwise a negative cycle was walked
+			if (edges[v] >= size)
+				cycle = true;
+			else if (!queued[v])
+			{
+				queued[v] = true;
+				worklist.push(v);
+			}
+		});
+		if (cycle)
+			return false;
+	}
+	return true;
+}
+
+int tightParent(Graph *graph, char option, int source, const int *dist, int v)
+{
+	int parent = -1;
+	if (v == source || dist[v] == INF)
+		return parent;
+	graph->forEachEdge(v, option == 'O' ? EDGE_IN : EDGE_BOTH, [&](int u, int w)
+	{
+		if (dist[u] != INF && dist[u] + w == dist[v] && (parent == -1 || dist[u] < dist[parent] || (dist[u] == dist[parent] && u < parent)))
+			parent = u;
+	});
+	return parent;
+}
+
+void tightParents(Graph *graph, char option, int source, const int *dist, int *parent)
+{
+	int size = graph->getSize();
+	for (int v = 0; v < size; v++)
+		parent[v] = tightParent(graph, option, source, dist, v);
+}
+
+void shortestPathTree(Graph *graph, char option, int source, const WeightRange &range, SSSPMode mode, vector<int> &dist, vector<int> &parent)
+{
+	bool large = graph->getEdgeCount() >= DELTA_STEPPING_MIN_EDGES && workerCount() > 1;
+	if (mode == SSSP_DELTA || (mode == SSSP_AUTO && large))
+		deltaSteppingTree(graph, option, source, range, dist, parent);
+	else
+		dijkstraTree(graph, option, source, range, dist, parent);
+}
+
+SSSPCache::SSSPCache(size_t budget)
+{
+	m_Budget = budget;
+	m_Bytes = 0;
+	m_Hits = 0;
+	m_Misses = 0;
+	m_Evictions = 0;
+}
+
+long long SSSPCache::makeKey(int source, char option, SSSPFamily family)
+{
+	return (long long)source << 2 | (option == 'O' ? 0 : 2) | (family == FAMILY_DIJKSTRA ? 0 : 1);
+}
+
+void SSSPCache::evict()
+{
+	while (m_Bytes > m_Budget && !m_Order.empty())
+	{
+		m_Bytes -= m_Order.back().bytes;
+		m_Index.erase(m_Order.back().key);
+		m_Order.pop_back();
+		m_Evictions++;
+	}
+}
+
+const SSSPTree *SSSPCache::find(int source, char option, SSSPFamily family)
+{
+	unordered_map<long long, list<Entry>::iterator>::iterator it = m_Index.find(makeKey(source, option, family));
+	if (it == m_Index.end())
+	{
+		m_Misses++;
+		return nullptr;
+	}
+	m_Hits++;
+	// most recently used goes to the front
+	m_Order.splice(m_Order.begin(), m_Order, it->second);
+	return &it->second->tree;
+}
+
+void SSSPCache::insert(int source, char option, SSSPFamily family, bool valid, vector<int> &dist, vector<int> &parent)
+{
+	long long key = makeKey(source, option, family);
+	size_t bytes = sizeof(Entry) + (dist.size() + parent.size()) * sizeof(int);
+	if (bytes > m_Budget || m_Index.count(key))
+		return;
+
+	m_Order.push_front(Entry());
+	Entry &entry = m_Order.front();
+	entry.key = key;
+	entry.bytes = bytes;
+	entry.tree.valid = valid;
+	entry.tree.dist.swap(dist);
+	entry.tree.parent.swap(parent);
+	m_Index[key] = m_Order.begin();
+	m_Bytes += bytes;
+	evict();
+}
+
+void SSSPCache::clear()
+{
+	m_Order.clear();
+	m_Index.clear();
+	m_Bytes = 0;
+}
+
+void SSSPCache::setBudget(size_t budget)
+{
+	m_Budget = budget;
+	evict();
+}
@@ -0,0 +1,146 @@
+#ifndef _SSSP_H_
+#define _SSSP_H_
+
+#include "Graph.h"
+#include "Parallel.h"
+#include <list>
+#include <unordered_map>
+
+// Smallest / largest edge weight seen from the option's perspective
+struct WeightRange
+{
+	int minWeight;
+	int maxWeight;
+	bool hasEdge;
+};
+
+// Dial buckets are used up to this largest weight, a radix heap above it
+const int DIAL_MAX_WEIGHT = 64;
+
+// Single source algorithm requested by DIJKSTRA
+enum SSSPMode
+{
+	SSSP_AUTO,       // delta-stepping from DELTA_STEPPING_MIN_EDGES edges on, sequential below
+	SSSP_SEQUENTIAL, // sequential Dijkstra
+	SSSP_DELTA       // parallel delta-stepping
+};
+
+const int DELTA_STEPPING_MIN_EDGES = 1 << 20;
+
+// option 'O' directed, otherwise undirected
+WeightRange scanWeights(Graph *graph, char option);
+
+// Dijkstra shortest path tree from source, every weight in range must be non-negative
+// the priority queue is chosen from the weight range
+// parent of a vertex is its tight predecessor popped first, i.e. smallest (dist, vertex)
+void dijkstraTree(Graph *graph, char option, int source, const WeightRange &range, vector<int> &dist, vector<int> &parent);
+
+// Parallel delta-stepping with light/heavy edge buckets, same dist and parent as dijkstraTree
+// needs every weight >= 1, falls back to dijkstraTree otherwise
+void deltaSteppingTree(Graph *graph, char option, int source, const WeightRange &range, vector<int> &dist, vector<int> &parent);
+
+// Queue based Bellman-Ford (SPFA), only vertices whose distance changed are rescanned
+// weights may be negative, returns false if a negative cycle is reachable from source
+bool bellmanFordTree(Graph *graph, char option, int source, vector<int> &dist, vector<int> &parent);
+
+// Rebuilds parent from dist alone : tight predecessor with the smallest (dist, vertex),
+// the parent dijkstraTree picks, needs every weight > 0 so no tight cycle exists
+void tightParents(Graph *graph, char option, int source, const int *dist, int *parent);
+// Same rule for the single vertex v, O(in-degree)
+int tightParent(Graph *graph, char option, int source, const int *dist, int v);
+
+// Dispatches to one of the above according to mode, graph size and weights
+void shortestPathTree(Graph *graph, char option, int source, const WeightRange &range, SSSPMode mode, vector<int> &dist, vector<int> &parent);
+
+// Dijkstra from every source in parallel, visit(index, dist, worker) gets each distance row
+// only one row per worker is alive at a time, every weight in range must be non-negative
+template <class F>
+void forEachSourceTree(Graph *graph, char option, const vector<int> &sources, const WeightRange &range, F visit)
+{
+	int workers = workerCount();
+	vector<vector<int>> dist(workers), parent(workers);
+	parallelFor(0, (int)sources.size(), [&](int i, int worker)
+	{
+		dijkstraTree(graph, option, sources[i], range, dist[worker], parent[worker]);
+		visit(i, dist[worker], worker);
+	});
+}
+
+// Algorithm family a cached tree came from
+enum SSSPFamily
+{
+	FAMILY_DIJKSTRA,
+	FAMILY_BELLMANFORD
+};
+
+// Shortest path tree of one source
+struct SSSPTree
+{
+	bool valid; // false if Bellman-Ford reached a negative cycle
+	vector<int> dist;
+	vector<int> parent;
+};
+
+// Default memory budget of the tree cache in bytes
+const size_t SSSP_CACHE_BUDGET = 64 << 20;
+
+// LRU cache of shortest path trees keyed by (source, option, family)
+// the least recently used trees are dropped once the byte budget is exceeded
+class SSSPCache
+{
+private:
+	struct Entry
+	{
+		long long key;
+		size_t bytes;
+		SSSPTree tree;
+	};
+
+	list<Entry> m_Order; // most recently used first
+	unordered_map<long long, list<Entry>::iterator> m_Index;
+	size_t m_Budget;
+	size_t m_Bytes;
+	long long m_Hits;
+	long long m_Misses;
+	long long m_Evictions;
+
+	static long long makeKey(int source, char option, SSSPFamily family);
+	void evict(); // down to the budget
+
+public:
+	SSSPCache(size_t budget = SSSP_CACHE_BUDGET);
+
+	// cached tree or nullptr, counts a hit or a miss
+	const SSSPTree *find(int source, char option, SSSPFamily family);
+	// takes the vectors over (left empty), skipped if the tree alone exceeds the budget
+	void insert(int source, char option, SSSPFamily family, bool valid, vector<int> &dist, vector<int> &parent);
+	void clear(); // drops every tree, counters are kept
+	void setBudget(size_t budget);
+
+	// f(source, option, tree) may change a tree in place, returning false drops it
+	template <class F>
+	void update(F f)
+	{
+		list<Entry>::iterator it = m_Order.begin();
+		while (it != m_Order.end())
+		{
+			if (f((int)(it->key >> 2), (it->key & 2) ? 'X' : 'O', it->tree))
+			{
+				it++;
+				continue;
+			}
+			m_Bytes -= it->bytes;
+			m_Index.erase(it->key);
+			it = m_Order.erase(it);
+		}
+	}
+
+	size_t getBudget() { return m_Budget; }
+	size_t getBytes() { return m_Bytes; }
+	int getTreeCount() { return (int)m_Order.size(); }
+	long long getHits() { return m_Hits; }
+	long long getMisses() { return m_Misses; }
+	long long getEvictions() { return m_Evictions; }
+};
+
+#endif
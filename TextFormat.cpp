@@ -0,0 +1,83 @@
+#include "TextFormat.h"
+
+// "00" "01" ... "99"
+static const char DIGIT_PAIRS[] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+static int digitCount(unsigned v)
+{
+	int n = 1;
+	while (true)
+	{
+		if (v < 10)
+			return n;
+		if (v < 100)
+			return n + 1;
+		if (v < 1000)
+			return n + 2;
+		if (v < 10000)
+			return n + 3;
+		v /= 10000;
+		n += 4;
+	}
+}
+
+int formatInt(char *out, int value)
+{
+	char *p = out;
+	unsigned v = (unsigned)value;
+	if (value < 0)
+	{
+		*p++ = '-';
+		v = 0u - v;
+	}
+
+	// fill from the last digit backwards
+	char *end = p + digitCount(v);
+	char *q = end;
+	while (v >= 100)
+	{
+		unsigned pair = (v % 100) * 2;
+		v /= 100;
+		q -= 2;
+		q[0] = DIGIT_PAIRS[pair];
+		q[1] = DIGIT_PAIRS[pair + 1];
+	}
+	if (v >= 10)
+	{
+		q[-2] = DIGIT_PAIRS[v * 2];
+		q[-1] = DIGIT_PAIRS[v * 2 + 1];
+	}
+	else
+		q[-1] = (char)('0' + v);
+	return (int)(end - out);
+}
+
+void formatMatrixHeader(TextBuffer &text, int size)
+{
+	text.put('\t');
+	for (int i = 0; i < size; i++)
+	{
+		text.putLabel(i);
+		text.put('\t');
+	}
+	text.put('\n');
+}
+
+void formatMatrixRow(TextBuffer &text, int i, const int *row, int size)
+{
+	text.putLabel(i);
+	text.put('\t');
+	for (int j = 0; j < size; j++)
+		text.putCell(row[j]);
+	text.put('\n');
+}
@@ -0,0 +1,92 @@
+#ifndef _TEXTFORMAT_H_
+#define _TEXTFORMAT_H_
+
+#include "Graph.h"
+#include "Parallel.h"
+
+// Rows formatted by one task of writeRows
+const int FORMAT_BLOCK_ROWS = 64;
+
+// Decimal digits of value into out (at most 11 chars, no terminator), returns the length
+// two digits per step from a lookup table
+int formatInt(char *out, int value);
+
+// Growable char buffer that text is formatted into directly
+class TextBuffer
+{
+private:
+	vector<char> m_Data;
+	size_t m_Size;
+
+	// room for n more chars
+	char *reserve(size_t n)
+	{
+		if (m_Size + n > m_Data.size())
+			m_Data.resize(max(m_Data.size() * 2, m_Size + n));
+		return &m_Data[m_Size];
+	}
+
+public:
+	TextBuffer() : m_Size(0) {}
+
+	const char *data() { return m_Data.data(); }
+	size_t size() { return m_Size; }
+	void clear() { m_Size = 0; }
+
+	void put(char c) { *reserve(1) = c; m_Size++; }
+	void put(const char *text, size_t length)
+	{
+		memcpy(reserve(length), text, length);
+		m_Size += length;
+	}
+	void put(const char *text) { put(text, strlen(text)); }
+	void putInt(int value) { m_Size += formatInt(reserve(11), value); }
+
+	// "[i]" row / column label
+	void putLabel(int i)
+	{
+		put('[');
+		putInt(i);
+		put(']');
+	}
+	// one matrix cell and its tab, INF as x
+	void putCell(int value)
+	{
+		if (value == INF)
+			put('x');
+		else
+			putInt(value);
+		put('\t');
+	}
+};
+
+// "\t[0]\t[1]\t ... [size - 1]\t\n", the header line of a matrix dump
+void formatMatrixHeader(TextBuffer &text, int size);
+// "[i]\t" then every cell of row, then "\n"
+void formatMatrixRow(TextBuffer &text, int i, const int *row, int size);
+
+// format(i, text) for every row in [0, count), blocks of rows are formatted in parallel
+// and written to out in row order, so the text is the same as a sequential loop
+template <class F>
+void writeRows(ostream &out, int count, F format)
+{
+	int workers = workerCount();
+	vector<TextBuffer> block(workers);
+	int wave = workers * FORMAT_BLOCK_ROWS;
+	for (int first = 0; first < count; first += wave)
+	{
+		int blocks = min(workers, (count - first + FORMAT_BLOCK_ROWS - 1) / FORMAT_BLOCK_ROWS);
+		parallelFor(0, blocks, [&](int b, int)
+		{
+			int begin = first + b * FORMAT_BLOCK_ROWS;
+			int end = min(count, begin + FORMAT_BLOCK_ROWS);
+			block[b].clear();
+			for (int i = begin; i < end; i++)
+				format(i, block[b]);
+		});
+		for (int b = 0; b < blocks; b++)
+			out.write(block[b].data(), block[b].size());
+	}
+}
+
+#endif
@@ -0,0 +1,258 @@
+#include "TextLoader.h"
+#include "GraphFile.h"
+#include "ListGraph.h"
+#include "MatrixGraph.h"
+#include "CSRGraph.h"
+#include "Parallel.h"
+
+// Lines [begin, end) of the file and what one task read from them
+struct TextChunk
+{
+	const char *begin;
+	const char *end;
+
+	// edges in file order, M edges keep their cell index in cell until it is made global
+	vector<int> from;
+	vector<int> to;
+	vector<int> weight;
+	vector<long long> cell;
+
+	// L : the first leading edges come before any vertex line, their vertex is in an earlier chunk
+	size_t leading;
+	bool hasVertex;
+	int lastVertex;
+
+	// M : weights read, malformed if the chunk stopped at text that is not an integer
+	long long cells;
+	bool malformed;
+
+	TextChunk() : begin(nullptr), end(nullptr), leading(0), hasVertex(false), lastVertex(-1), cells(0), malformed(false) {}
+};
+
+// whitespace of the C locale
+static inline bool isSpace(char c)
+{
+	return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+// One integer the way istream >> int reads it : whitespace, optional sign, decimal digits,
+// p is left on the first char after the digits so "3-4" reads 3 then -4
+// false if there is no digit or the value does not fit in an int
+static inline bool scanInt(const char *&p, const char *end, int &value)
+{
+	while (p < end && isSpace(*p))
+		p++;
+	const char *q = p;
+	bool negative = false;
+	if (q < end && (*q == '-' || *q == '+'))
+	{
+		negative = *q == '-';
+		q++;
+	}
+	const char *digits = q;
+	unsigned long long v = 0;
+	while (q < end && (unsigned)(*q - '0') < 10)
+	{
+		// saturates far above the int range, the range check below still fails
+		if (v < 10000000000ULL)
+			v = v * 10 + (unsigned)(*q - '0');
+		q++;
+	}
+	if (q == digits || v > (negative ? 2147483648ULL : 2147483647ULL))
+		return false;
+	value = negative ? (int)(0 - v) : (int)v;
+	p = q;
+	return true;
+}
+
+// Chunks of about the same size ending after a '\n', a few per worker
+static void splitChunks(const char *begin, const char *end, vector<TextChunk> &chunks)
+{
+	size_t target = (size_t)(end - begin) / (workerCount() * 4);
+	target = min(max(target, TEXT_CHUNK_MIN), TEXT_CHUNK_MAX);
+	const char *p = begin;
+	while (p < end)
+	{
+		const char *stop = end;
+		if ((size_t)(end - p) > target)
+		{
+			const char *newline = (const char *)memchr(p + target, '\n', end - (p + target));
+			stop = newline != nullptr ? newline + 1 : end;
+		}
+		chunks.push_back(TextChunk());
+		chunks.back().begin = p;
+		chunks.back().end = stop;
+		p = stop;
+	}
+}
+
+// L lines : a line with one integer starts the edges of that vertex,
+// a longer line holds (to, weight) pairs and an odd last integer is ignored
+static void parseListChunk(TextChunk &chunk)
+{
+	const char *p = chunk.begin;
+	int current = -1;
+	while (p < chunk.end)
+	{
+		const char *lineEnd = (const char *)memchr(p, '\n', chunk.end - p);
+		if (lineEnd == nullptr)
+			lineEnd = chunk.end;
+
+		int first, second;
+		if (scanInt(p, lineEnd, first))
+		{
+			if (!scanInt(p, lineEnd, second))
+			{
+				current = first;
+				chunk.hasVertex = true;
+			}
+			else
+			{
+				int to = first, weight = second;
+				do
+				{
+					// current is -1 before any vertex line, those edges are dropped by insertEdge
+					chunk.from.push_back(current);
+					chunk.to.push_back(to);
+					chunk.weight.push_back(weight);
+					if (!chunk.hasVertex)
+						chunk.leading++;
+				} while (scanInt(p, lineEnd, to) && scanInt(p, lineEnd, weight));
+			}
+		}
+		if (lineEnd == chunk.end)
+			break;
+		p = lineEnd + 1;
+	}
+	chunk.lastVertex = current;
+}
+
+// M weights in row-major order, zero weights are not edges
+static void parseMatrixChunk(TextChunk &chunk)
+{
+	const char *p = chunk.begin;
+	long long cell = 0;
+	int w;
+	while (scanInt(p, chunk.end, w))
+	{
+		if (w != 0)
+		{
+			chunk.cell.push_back(cell);
+			chunk.weight.push_back(w);
+		}
+		cell++;
+	}
+	chunk.cells = cell;
+	// scanInt stopped on something other than the end of the chunk
+	chunk.malformed = p < chunk.end;
+}
+
+Graph *loadTextGraph(const char *filename, bool csr)
+{
+	MappedFile file;
+	if (!file.map(filename))
+		return nullptr;
+	const char *p = file.data();
+	const char *end = p + file.size();
+
+	// header : type word and vertex count
+	while (p < end && isSpace(*p))
+		p++;
+	const char *type = p;
+	while (p < end && !isSpace(*p))
+		p++;
+	char format = p - type == 1 ? *type : '\0';
+	int size;
+	if ((format != 'L' && format != 'M') || !scanInt(p, end, size) || size < 0)
+		return nullptr;
+	// L data starts on the next line, M weights right after the count
+	if (format == 'L')
+	{
+		const char *newline = (const char *)memchr(p, '\n', end - p);
+		p = newline != nullptr ? newline + 1 : end;
+	}
+
+	vector<TextChunk> chunks;
+	splitChunks(p, end, chunks);
+	parallelFor(0, (int)chunks.size(), [&](int i, int)
+	{
+		if (format == 'L')
+			parseListChunk(chunks[i]);
+		else
+			parseMatrixChunk(chunks[i]);
+	});
+
+	size_t used = chunks.size(); // chunks whose edges are inserted
+	if (format == 'L')
+	{
+		// leading edges belong to the last vertex line of the chunks before
+		int carry = -1;
+		for (size_t c = 0; c < chunks.size(); c++)
+		{
+			for (size_t i = 0; i < chunks[c].leading; i++)
+				chunks[c].from[i] = carry;
+			if (chunks[c].hasVertex)
+				carry = chunks[c].lastVertex;
+		}
+	}
+	else
+	{
+		// weights count up to the first malformed one, size * size of them are needed
+		vector<long long> first(chunks.size());
+		long long read = 0;
+		for (size_t c = 0; c < chunks.size(); c++)
+		{
+			first[c] = read;
+			read += chunks[c].cells;
+			if (chunks[c].malformed)
+			{
+				used = c + 1;
+				break;
+			}
+		}
+		long long cells = (long long)size * size;
+		if (read < cells)
+			return nullptr;
+
+		// cell index -> (row, column), cells past the matrix are dropped
+		parallelFor(0, (int)used, [&](int c, int)
+		{
+			TextChunk &chunk = chunks[c];
+			size_t count = 0;
+			while (count < chunk.cell.size() && first[c] + chunk.cell[count] < cells)
+				count++;
+			chunk.from.resize(count);
+			chunk.to.resize(count);
+			chunk.weight.resize(count);
+			for (size_t i = 0; i < count; i++)
+			{
+				long long g = first[c] + chunk.cell[i];
+				chunk.from[i] = (int)(g / size);
+				chunk.to[i] = (int)(g % size);
+			}
+			vector<long long>().swap(chunk.cell);
+		});
+	}
+
+	Graph *graph;
+	if (csr)
+		graph = new CSRGraph(false, size, format); // Compressed Sparse Row
+	else if (format == 'L')
+		graph = new ListGraph(false, size); // Adjacent List
+	else
+		graph = new MatrixGraph(false, size); // Adjacent Matrix
+
+	// bulk insert in file order, each chunk released once it is stored
+	for (size_t c = 0; c < used; c++)
+	{
+		TextChunk &chunk = chunks[c];
+		graph->insertEdges(chunk.from.data(), chunk.to.data(), chunk.weight.data(), chunk.from.size());
+		vector<int>().swap(chunk.from);
+		vector<int>().swap(chunk.to);
+		vector<int>().swap(chunk.weight);
+	}
+	// compact staged edges once, after every edge is known
+	if (csr)
+		((CSRGraph *)graph)->build();
+	return graph;
+}
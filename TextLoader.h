@@ -0,0 +1,19 @@
+#ifndef _TEXTLOADER_H_
+#define _TEXTLOADER_H_
+
+#include "Graph.h"
+
+// Bytes of text parsed by one task, chunks end at line boundaries
+const size_t TEXT_CHUNK_MIN = 1 << 16;
+const size_t TEXT_CHUNK_MAX = 1 << 22;
+
+// Reads a graph_L / graph_M text file : the file is mapped, split into chunks of whole lines
+// and the chunks are parsed in parallel, then their edges are inserted in file order
+// integers are read the way istream >> int reads them, so the graph is the same as a
+// line by line stream parse
+// csr == true builds a CSRGraph regardless of the format
+// nullptr if the file cannot be read, the type is not L or M, the vertex count is missing
+// or an M file holds fewer than size * size readable weights
+Graph *loadTextGraph(const char *filename, bool csr);
+
+#endif